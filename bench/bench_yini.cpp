@@ -0,0 +1,350 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include "yini.hpp"
+#include "corpus.hpp"
+
+// Count every heap allocation made by the process. Every replaceable
+// form of operator new/delete is replaced, so aligned and nothrow
+// allocations are counted too. The bodies go through out-of-line helpers:
+// GCC otherwise inlines them and reports malloc/free inside the
+// replacements as mismatched with new/delete (-Wmismatched-new-delete).
+static std::atomic<std::uint64_t> g_allocations{0};
+
+namespace {
+
+#if defined(__GNUC__)
+#define YINI_BENCH_NOINLINE __attribute__((noinline))
+#else
+#define YINI_BENCH_NOINLINE
+#endif
+
+YINI_BENCH_NOINLINE void* counted_allocate(std::size_t size, std::size_t alignment) noexcept {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (alignment <= alignof(std::max_align_t)) return std::malloc(size ? size : 1);
+
+    // Over-allocate and keep the malloc pointer just below the aligned block
+    void* raw = std::malloc(size + alignment + sizeof(void*));
+    if (!raw) return nullptr;
+    std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+    void* aligned = reinterpret_cast<void*>((start + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1));
+    static_cast<void**>(aligned)[-1] = raw;
+    return aligned;
+}
+
+YINI_BENCH_NOINLINE void counted_free(void* p, std::size_t alignment) noexcept {
+    if (!p) return;
+    std::free(alignment <= alignof(std::max_align_t) ? p : static_cast<void**>(p)[-1]);
+}
+
+void* counted_new(std::size_t size, std::size_t alignment) {
+    if (void* p = counted_allocate(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+
+constexpr std::size_t default_alignment = alignof(std::max_align_t);
+
+} // namespace
+
+void* operator new(std::size_t size) { return counted_new(size, default_alignment); }
+void* operator new[](std::size_t size) { return counted_new(size, default_alignment); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return counted_allocate(size, default_alignment); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_allocate(size, default_alignment);
+}
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return counted_new(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return counted_new(size, static_cast<std::size_t>(alignment));
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return counted_allocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return counted_allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept { counted_free(p, default_alignment); }
+void operator delete[](void* p) noexcept { counted_free(p, default_alignment); }
+void operator delete(void* p, std::size_t) noexcept { counted_free(p, default_alignment); }
+void operator delete[](void* p, std::size_t) noexcept { counted_free(p, default_alignment); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { counted_free(p, default_alignment); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { counted_free(p, default_alignment); }
+void operator delete(void* p, std::align_val_t alignment) noexcept {
+    counted_free(p, static_cast<std::size_t>(alignment));
+}
+void operator delete[](void* p, std::align_val_t alignment) noexcept {
+    counted_free(p, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept {
+    counted_free(p, static_cast<std::size_t>(alignment));
+}
+void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept {
+    counted_free(p, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    counted_free(p, static_cast<std::size_t>(alignment));
+}
+void operator delete[](void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    counted_free(p, static_cast<std::size_t>(alignment));
+}
+
+namespace {
+
+double peak_rss_mb() {
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0);  // bytes
+#else
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;  // KiB
+#endif
+#else
+    return 0.0;
+#endif
+}
+
+// Bytes/s, allocations per KiB of input and peak RSS for one benchmark
+class Meter {
+private:
+    benchmark::State& state_;
+    std::uint64_t allocations_;
+
+public:
+    explicit Meter(benchmark::State& state)
+        : state_(state), allocations_(g_allocations.load(std::memory_order_relaxed)) {}
+
+    // Pass 0 for benchmarks that do not consume input; they report
+    // allocations per iteration instead
+    void finish(size_t bytes_per_iteration) {
+        double allocations = static_cast<double>(g_allocations.load(std::memory_order_relaxed) - allocations_);
+        double total_bytes = static_cast<double>(bytes_per_iteration) * static_cast<double>(state_.iterations());
+        if (total_bytes > 0) {
+            state_.SetBytesProcessed(static_cast<std::int64_t>(total_bytes));
+            state_.counters["allocs_per_KB"] = allocations / (total_bytes / 1024.0);
+        } else {
+            state_.counters["allocs_per_op"] = allocations / static_cast<double>(state_.iterations());
+        }
+        state_.counters["peak_rss_MB"] = peak_rss_mb();
+    }
+};
+
+const std::string& corpus(size_t bytes, int depth, size_t array_width, int comment_percent) {
+    struct Entry {
+        size_t bytes;
+        int depth;
+        size_t array_width;
+        int comment_percent;
+        std::string text;
+    };
+    static std::deque<Entry> cache;  // Stable references
+    for (const Entry& entry : cache) {
+        if (entry.bytes == bytes && entry.depth == depth && entry.array_width == array_width &&
+            entry.comment_percent == comment_percent) {
+            return entry.text;
+        }
+    }
+
+    yini_bench::CorpusOptions options;
+    options.target_bytes = bytes;
+    options.depth = depth;
+    options.array_width = array_width;
+    options.comment_density = comment_percent / 100.0;
+    cache.push_back(Entry{bytes, depth, array_width, comment_percent, yini_bench::generate_corpus(options)});
+    return cache.back().text;
+}
+
+// Args: bytes, depth, array width, comment percentage
+void BM_ParseString(benchmark::State& state) {
+    const std::string& text = corpus(static_cast<size_t>(state.range(0)), static_cast<int>(state.range(1)),
+                                     static_cast<size_t>(state.range(2)), static_cast<int>(state.range(3)));
+    Meter meter(state);
+    for (auto _ : state) {
+        yini::Parser parser;
+        parser.parse_string(text);
+        benchmark::DoNotOptimize(parser.root());
+    }
+    meter.finish(text.size());
+}
+BENCHMARK(BM_ParseString)
+    ->ArgNames({"bytes", "depth", "width", "comments%"})
+    ->Args({16 << 10, 2, 4, 10})
+    ->Args({1 << 20, 2, 4, 10})
+    ->Args({16 << 20, 2, 4, 10})
+    ->Args({1 << 20, 0, 4, 10})
+    ->Args({1 << 20, 6, 4, 10})
+    ->Args({1 << 20, 2, 0, 10})
+    ->Args({1 << 20, 2, 32, 10})
+    ->Args({1 << 20, 2, 4, 0})
+    ->Args({1 << 20, 2, 4, 80})
+    ->Unit(benchmark::kMicrosecond);
+
+// Same corpus as BM_ParseString/1MiB with ParseStats instrumentation on
+void BM_ParseStringWithStats(benchmark::State& state) {
+    const std::string& text = corpus(1 << 20, 2, 4, 10);
+    yini::ParseStats stats;
+    Meter meter(state);
+    for (auto _ : state) {
+        yini::Parser parser;
+        parser.parse_string(text, stats);
+        benchmark::DoNotOptimize(parser.root());
+    }
+    meter.finish(text.size());
+}
+BENCHMARK(BM_ParseStringWithStats)->Unit(benchmark::kMicrosecond);
+
+// Lexer and value classification only; no tree is built
+void BM_SaxScan(benchmark::State& state) {
+    const std::string& text = corpus(static_cast<size_t>(state.range(0)), 2, 4, static_cast<int>(state.range(1)));
+    yini::Visitor visitor;
+    Meter meter(state);
+    for (auto _ : state) {
+        yini::sax_parse(text, visitor);
+    }
+    meter.finish(text.size());
+}
+BENCHMARK(BM_SaxScan)
+    ->ArgNames({"bytes", "comments%"})
+    ->Args({1 << 20, 10})
+    ->Args({1 << 20, 80})
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_WriteString(benchmark::State& state) {
+    const std::string& text = corpus(static_cast<size_t>(state.range(0)), 2, 4, 10);
+    yini::Parser parser;
+    parser.parse_string(text);
+    size_t written = parser.write_string().size();
+
+    Meter meter(state);
+    for (auto _ : state) {
+        std::string output = parser.write_string();
+        benchmark::DoNotOptimize(output.data());
+    }
+    meter.finish(written);
+}
+BENCHMARK(BM_WriteString)->ArgName("bytes")->Arg(16 << 10)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+
+// One tenant variant of a 1 MiB base: clone plus a small override
+void BM_CloneOverlay(benchmark::State& state) {
+    const std::string& text = corpus(1 << 20, 2, 4, 10);
+    yini::Parser base;
+    base.parse_string(text);
+    const std::string overrides = "name = 'tenant'\n^ section10\n    key1 = 99\n    ^^ child1\n        key2 = 'x'\n";
+
+    Meter meter(state);
+    for (auto _ : state) {
+        yini::Parser tenant = base.clone();
+        tenant.overlay(overrides);
+        benchmark::DoNotOptimize(tenant.root());
+    }
+    meter.finish(0);
+}
+BENCHMARK(BM_CloneOverlay)->Unit(benchmark::kMicrosecond);
+
+void BM_SectionLookup(benchmark::State& state) {
+    const std::string& text = corpus(1 << 20, 2, 4, 10);
+    yini::Parser parser;
+    parser.parse_string(text);
+    const yini::Section& root = parser.root();
+
+    std::vector<std::string> names;
+    for (auto it = root.sections_begin(); it != root.sections_end(); ++it) names.push_back(it->first);
+
+    size_t index = 0;
+    Meter meter(state);
+    for (auto _ : state) {
+        const yini::Section& section = root.get_section(names[index]);
+        benchmark::DoNotOptimize(&section.at("key3"));
+        index = index + 1 == names.size() ? 0 : index + 1;
+    }
+    meter.finish(0);
+}
+BENCHMARK(BM_SectionLookup);
+
+// BM_SectionLookup with interned keys, so neither lookup hashes
+void BM_AtomLookup(benchmark::State& state) {
+    const std::string& text = corpus(1 << 20, 2, 4, 10);
+    yini::Parser parser;
+    parser.parse_string(text);
+    const yini::Section& root = parser.root();
+
+    std::vector<yini::Atom> names;
+    for (auto it = root.sections_begin(); it != root.sections_end(); ++it) names.push_back(yini::intern(it->first));
+    yini::Atom key = yini::intern("key3");
+
+    size_t index = 0;
+    Meter meter(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(&root.find_section(names[index])->at(key));
+        index = index + 1 == names.size() ? 0 : index + 1;
+    }
+    meter.finish(0);
+}
+BENCHMARK(BM_AtomLookup);
+
+void BM_PathLookup(benchmark::State& state) {
+    const std::string& text = corpus(1 << 20, 2, 4, 10);
+    yini::Parser parser;
+    parser.parse_string(text);
+    yini::Path path = yini::compile_path("section100.child1.child2.key5");
+
+    Meter meter(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parser.find(path));
+    }
+    meter.finish(0);
+}
+BENCHMARK(BM_PathLookup);
+
+// Resolving a key through four stacked copies of the corpus
+void BM_LayeredLookup(benchmark::State& state) {
+    const std::string& text = corpus(1 << 20, 2, 4, 10);
+    std::vector<std::shared_ptr<const yini::Section>> layers;
+    for (int i = 0; i < 4; ++i) {
+        yini::Parser parser;
+        parser.parse_string(text);
+        layers.push_back(std::make_shared<yini::Section>(std::move(parser.root())));
+    }
+    yini::Layered layered(std::move(layers));
+
+    Meter meter(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(layered.find("section100.child1.child2.key5"));
+    }
+    meter.finish(0);
+}
+BENCHMARK(BM_LayeredLookup);
+
+void BM_ValueConversion(benchmark::State& state) {
+    std::vector<yini::Value> values = {yini::Value(42), yini::Value(2.5), yini::Value(true),
+                                       yini::Value("1234"), yini::Value("yes")};
+    Meter meter(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(values[0].as_int());
+        benchmark::DoNotOptimize(values[1].as_double());
+        benchmark::DoNotOptimize(values[2].as_bool());
+        benchmark::DoNotOptimize(values[3].as_int());
+        benchmark::DoNotOptimize(values[4].as_bool());
+        benchmark::DoNotOptimize(values[0].as_string());
+    }
+    meter.finish(0);
+}
+BENCHMARK(BM_ValueConversion);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,113 @@
+#ifndef YINI_BENCH_CORPUS_HPP
+#define YINI_BENCH_CORPUS_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace yini_bench {
+
+// Shape of a synthetic YINI document
+struct CorpusOptions {
+    size_t target_bytes = 1 << 20;   // Stop adding top-level sections past this size
+    int depth = 2;                   // Nesting levels below each top-level section
+    size_t keys_per_section = 8;
+    size_t array_width = 4;          // Elements per array value; 0 disables arrays
+    double comment_density = 0.1;    // Probability of a comment after each line
+    std::uint64_t seed = 1;
+};
+
+// splitmix64: tiny, fast and identical on every platform, unlike the
+// distributions in <random>
+class Random {
+private:
+    std::uint64_t state_;
+
+public:
+    explicit Random(std::uint64_t seed) : state_(seed) {}
+
+    std::uint64_t next() {
+        std::uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    size_t below(size_t bound) { return static_cast<size_t>(next() % bound); }
+    double unit() { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0); }
+};
+
+namespace detail {
+
+inline void append_scalar(std::string& out, Random& random) {
+    switch (random.below(4)) {
+        case 0:
+            out += '\'';
+            out += "value_" + std::to_string(random.below(100000));
+            out += '\'';
+            break;
+        case 1:
+            out += std::to_string(static_cast<std::int64_t>(random.next() % 2000000) - 1000000);
+            break;
+        case 2:
+            out += std::to_string(random.below(100000)) + "." + std::to_string(random.below(1000));
+            break;
+        default:
+            out += random.below(2) ? "true" : "false";
+            break;
+    }
+}
+
+inline void append_comment(std::string& out, Random& random, const CorpusOptions& options) {
+    if (random.unit() >= options.comment_density) return;
+    if (random.below(2)) {
+        out += "// comment " + std::to_string(random.below(1000)) + "\n";
+    } else {
+        out += "/* block\n   comment */\n";
+    }
+}
+
+inline void append_section(std::string& out, Random& random, const CorpusOptions& options,
+                           const std::string& name, int level) {
+    std::string indent(static_cast<size_t>(level - 1) * 4, ' ');
+    out += indent + std::string(static_cast<size_t>(level), '^') + " " + name + "\n";
+    append_comment(out, random, options);
+
+    for (size_t k = 0; k < options.keys_per_section; ++k) {
+        out += indent + "    key" + std::to_string(k) + " = ";
+        if (options.array_width > 0 && random.below(4) == 0) {
+            out += '[';
+            for (size_t i = 0; i < options.array_width; ++i) {
+                if (i > 0) out += ", ";
+                append_scalar(out, random);
+            }
+            out += ']';
+        } else {
+            append_scalar(out, random);
+        }
+        out += '\n';
+        append_comment(out, random, options);
+    }
+
+    if (level <= options.depth) {
+        append_section(out, random, options, "child" + std::to_string(level), level + 1);
+    }
+}
+
+} // namespace detail
+
+// Deterministic document: the same options always give the same bytes
+inline std::string generate_corpus(const CorpusOptions& options) {
+    Random random(options.seed);
+    std::string out;
+    out.reserve(options.target_bytes + 4096);
+    out += "name = 'bench'\nversion = 1\n";
+
+    for (size_t section = 0; out.size() < options.target_bytes; ++section) {
+        detail::append_section(out, random, options, "section" + std::to_string(section), 1);
+    }
+    return out;
+}
+
+} // namespace yini_bench
+
+#endif // YINI_BENCH_CORPUS_HPP
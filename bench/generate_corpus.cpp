@@ -0,0 +1,31 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "corpus.hpp"
+
+// yini-corpus <output> [bytes] [depth] [array_width] [comment_percent] [seed]
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: yini-corpus <output> [bytes] [depth] [array_width] [comment_percent] [seed]" << std::endl;
+        return 1;
+    }
+
+    yini_bench::CorpusOptions options;
+    if (argc > 2) options.target_bytes = std::strtoull(argv[2], nullptr, 10);
+    if (argc > 3) options.depth = std::atoi(argv[3]);
+    if (argc > 4) options.array_width = std::strtoull(argv[4], nullptr, 10);
+    if (argc > 5) options.comment_density = std::atoi(argv[5]) / 100.0;
+    if (argc > 6) options.seed = std::strtoull(argv[6], nullptr, 10);
+
+    std::string corpus = yini_bench::generate_corpus(options);
+    std::ofstream out(argv[1], std::ios::binary);
+    out.write(corpus.data(), static_cast<std::streamsize>(corpus.size()));
+    if (!out) {
+        std::cerr << "cannot write " << argv[1] << std::endl;
+        return 1;
+    }
+    std::cout << "wrote " << corpus.size() << " bytes to " << argv[1] << std::endl;
+    return 0;
+}
@@ -0,0 +1,210 @@
+// Throughput of every parse path on a fixed corpus, with an optional
+// regression gate against a recorded baseline:
+//
+//   yini-perfcheck --record baseline.txt
+//   yini-perfcheck --baseline baseline.txt --threshold 0.2
+//
+// The corpus is tests/example.yini followed by a generated document, so
+// numbers from different runs of the same build are comparable. Rates are
+// bytes of corpus text per second, also for the binary snapshot, and every
+// path is checked against parse_string() before it is timed.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "yini.hpp"
+#include "corpus.hpp"
+#include "differential.hpp"
+
+namespace {
+
+struct Path {
+    const char* name;
+    std::function<void()> run;
+};
+
+// Best of several rounds; each round runs for at least min_seconds
+double best_mb_per_second(const std::function<void()>& run, size_t bytes, double min_seconds) {
+    using Clock = std::chrono::steady_clock;
+    double best = 0;
+    for (int round = 0; round < 5; ++round) {
+        size_t iterations = 0;
+        Clock::time_point start = Clock::now();
+        double elapsed = 0;
+        do {
+            run();
+            ++iterations;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < min_seconds);
+        best = std::max(best, static_cast<double>(bytes) * static_cast<double>(iterations) / elapsed / 1e6);
+    }
+    return best;
+}
+
+// Whole-string number parse; false for empty input or trailing junk
+bool parse_number(const std::string& text, double& out) {
+    char* end = nullptr;
+    out = std::strtod(text.c_str(), &end);
+    return !text.empty() && end == text.c_str() + text.size() && std::isfinite(out);
+}
+
+// One "name rate" pair per line, as written by --record
+std::map<std::string, double> read_baseline(const std::string& filename) {
+    std::ifstream in(filename);
+    if (!in) throw yini::FileError("Cannot open file: " + filename);
+    std::map<std::string, double> baseline;
+    std::string line;
+    size_t number = 0;
+    while (std::getline(in, line)) {
+        ++number;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        std::istringstream fields(line);
+        std::string name;
+        std::string rate_text;
+        std::string extra;
+        double rate = 0;
+        if (!(fields >> name >> rate_text) || (fields >> extra) || !parse_number(rate_text, rate) || rate <= 0) {
+            throw std::runtime_error(filename + ":" + std::to_string(number) + ": expected 'name rate', got '" + line +
+                                     "'");
+        }
+        baseline[name] = rate;
+    }
+    if (baseline.empty()) throw std::runtime_error(filename + ": no baseline entries");
+    return baseline;
+}
+
+int usage(const char* program) {
+    std::cerr << "usage: " << program
+              << " [--seed FILE] [--record FILE] [--baseline FILE] [--threshold FRACTION] [--seconds S]" << std::endl;
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string seed_file = "tests/example.yini";
+    std::string record_file;
+    std::string baseline_file;
+    double threshold = 0.2;
+    double seconds = 0.1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 == argc) return usage(argv[0]);
+        if (arg == "--seed") {
+            seed_file = argv[++i];
+        } else if (arg == "--record") {
+            record_file = argv[++i];
+        } else if (arg == "--baseline") {
+            baseline_file = argv[++i];
+        } else if (arg == "--threshold") {
+            if (!parse_number(argv[++i], threshold) || threshold < 0 || threshold >= 1) {
+                std::cerr << "--threshold must be a fraction in [0, 1), got '" << argv[i] << "'" << std::endl;
+                return 2;
+            }
+        } else if (arg == "--seconds") {
+            if (!parse_number(argv[++i], seconds) || seconds <= 0) {
+                std::cerr << "--seconds must be a positive number, got '" << argv[i] << "'" << std::endl;
+                return 2;
+            }
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    try {
+        std::ifstream in(seed_file);
+        if (!in) throw yini::FileError("Cannot open file: " + seed_file);
+        std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        yini_bench::CorpusOptions options;
+        options.target_bytes = 1 << 20;
+        options.comment_density = 0.2;
+        text += "\n" + yini_bench::generate_corpus(options);
+
+        yini::Parser reference;
+        reference.parse_string(text);
+        const std::string image = yini::detail::binary::Encoder().encode(reference.root(), 0);
+
+        std::vector<Path> paths = {
+            {"text", [&]() { yini::Parser parser; parser.parse_string(text); }},
+            {"zero_copy", [&]() { yini::Parser parser; parser.parse(std::string_view(text)); }},
+            {"scan", [&]() { yini::Visitor visitor; yini::sax_parse(text, visitor); }},
+            {"push", [&]() {
+                 yini::Parser parser;
+                 for (size_t offset = 0; offset < text.size(); offset += 4096) {
+                     parser.feed(text.data() + offset, std::min<size_t>(4096, text.size() - offset));
+                 }
+                 parser.finish();
+             }},
+            {"parallel", [&]() { yini::Parser parser; parser.parse_parallel(text); }},
+            {"lazy", [&]() {
+                 yini::LazyDocument lazy;
+                 lazy.parse(text);
+                 for (std::string_view name : lazy.section_names()) lazy.get_section(name);
+             }},
+            {"document", [&]() { yini::Document document; document.parse(text); }},
+            {"binary", [&]() {
+                 yini::Section decoded;
+                 yini::detail::binary::Decoder(image).decode_into(decoded);
+             }},
+            {"write", [&]() { std::string out = reference.write_string(); }},
+        };
+
+        // Identical trees first: a fast path that drifts is a bug, not a win
+        std::string failure = yini_check::check(text);
+        if (!failure.empty()) {
+            std::cerr << "Parse paths disagree on the corpus: " << failure << std::endl;
+            return 1;
+        }
+
+        std::map<std::string, double> baseline;
+        if (!baseline_file.empty()) baseline = read_baseline(baseline_file);
+        for (const auto& entry : baseline) {
+            bool known = std::any_of(paths.begin(), paths.end(), [&](const Path& path) { return entry.first == path.name; });
+            if (!known) throw std::runtime_error(baseline_file + ": unknown path '" + entry.first + "'");
+        }
+
+        std::ostringstream record;
+        bool regressed = false;
+        std::cout << "corpus: " << text.size() << " bytes" << std::endl;
+        for (const Path& path : paths) {
+            double rate = best_mb_per_second(path.run, text.size(), seconds);
+            record << path.name << " " << rate << "\n";
+            std::cout << path.name << ": " << rate << " MB/s";
+
+            auto it = baseline.find(path.name);
+            if (it != baseline.end()) {
+                double change = rate / it->second - 1.0;
+                std::cout << " (" << (change >= 0 ? "+" : "") << change * 100.0 << "% vs baseline)";
+                if (change < -threshold) {
+                    std::cout << " REGRESSION";
+                    regressed = true;
+                }
+            }
+            std::cout << std::endl;
+        }
+
+        if (!record_file.empty()) {
+            std::ofstream out(record_file);
+            if (!out) throw yini::FileError("Cannot write to file: " + record_file);
+            out << record.str();
+        }
+        return regressed ? 1 : 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "perf check failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,18 @@
+// libFuzzer entry point: every input goes through the differential check,
+// and any disagreement between parse paths aborts with the mismatch.
+//
+//   mkdir corpus && cp tests/example.yini corpus/ && yini-fuzz corpus/
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "differential.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, size_t size) {
+    std::string failure = yini_check::check(std::string_view(reinterpret_cast<const char*>(data), size));
+    if (!failure.empty()) {
+        std::fprintf(stderr, "%s\n", failure.c_str());
+        std::abort();
+    }
+    return 0;
+}
@@ -0,0 +1,30 @@
+// Runs saved inputs through the fuzz target without libFuzzer, so crashes
+// found elsewhere reproduce with any compiler:
+//
+//   yini-fuzz-replay crash-1234 corpus/*
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, size_t size);
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " FILE..." << std::endl;
+        return 2;
+    }
+    for (int i = 1; i < argc; ++i) {
+        std::ifstream in(argv[i], std::ios::binary);
+        if (!in) {
+            std::cerr << "Cannot open file: " << argv[i] << std::endl;
+            return 2;
+        }
+        std::string input((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(reinterpret_cast<const std::uint8_t*>(input.data()), input.size());
+        std::cout << argv[i] << ": ok" << std::endl;
+    }
+    return 0;
+}
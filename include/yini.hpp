@@ -2,24 +2,85 @@
 #define YINI_HPP
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
+#include <deque>
 #include <fstream>
 #include <sstream>
 #include <variant>
+#include <tuple>
 #include <memory>
+#include <functional>
+#include <utility>
+#include <memory_resource>
+#include <new>
 #include <stdexcept>
 #include <algorithm>
 #include <cctype>
+#include <cmath>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <system_error>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <chrono>
+#include <mutex>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Vector instructions for the structural scanner; define YINI_NO_SIMD to
+// use the portable path only
+#if !defined(YINI_NO_SIMD)
+#if defined(__AVX2__)
+#define YINI_SIMD_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define YINI_SIMD_SSE2 1
+#include <emmintrin.h>
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+// AVX2 path compiled with a target attribute and chosen at run time
+#define YINI_SIMD_AVX2_DISPATCH 1
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define YINI_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
 
 namespace yini {
 
 // Forward declarations
 class Section;
 class Value;
+class PackedArray;
 
 // Type alias for the value variant
-using ValueType = std::variant<std::string, int, double, bool, std::vector<Value>>;
+using ValueType = std::variant<std::string, std::int64_t, double, bool, std::vector<Value>, PackedArray>;
 
 // Exception classes
 class ParseError : public std::runtime_error {
@@ -32,58 +93,375 @@ public:
     explicit FileError(const std::string& message) : std::runtime_error("YINI File Error: " + message) {}
 };
 
+// Lightweight read-only view over contiguous elements
+template <typename T>
+class Span {
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+
+public:
+    Span() = default;
+    Span(T* data, size_t size) : data_(data), size_(size) {}
+
+    T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    T& operator[](size_t index) const { return data_[index]; }
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+};
+
+namespace detail {
+
+inline bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+inline std::string_view trim(std::string_view str) {
+    size_t start = 0;
+    while (start < str.size() && is_space(str[start])) ++start;
+    size_t end = str.size();
+    while (end > start && is_space(str[end - 1])) --end;
+    return str.substr(start, end - start);
+}
+
+inline char to_lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// ASCII case-insensitive comparison, independent of the global locale
+inline bool iequals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (to_lower(a[i]) != to_lower(b[i])) return false;
+    }
+    return true;
+}
+
+inline bool parse_bool(std::string_view text, bool& out) {
+    if (text.empty() || text.size() > 5) return false;
+    if (iequals(text, "true") || iequals(text, "yes") || iequals(text, "on")) {
+        out = true;
+        return true;
+    }
+    if (iequals(text, "false") || iequals(text, "no") || iequals(text, "off")) {
+        out = false;
+        return true;
+    }
+    return false;
+}
+
+// Strips a leading '+' that std::from_chars would reject
+inline std::string_view strip_plus(std::string_view text) {
+    if (text.size() > 1 && text[0] == '+' && text[1] != '-') text.remove_prefix(1);
+    return text;
+}
+
+// Whole-token integer parse; never throws
+template <typename Int>
+bool parse_int(std::string_view text, Int& out) {
+    text = strip_plus(text);
+    if (text.empty()) return false;
+    const char* end = text.data() + text.size();
+    auto result = std::from_chars(text.data(), end, out);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+// Whole-token floating point parse; rejects inf/nan spellings
+inline bool parse_double(std::string_view text, double& out) {
+    text = strip_plus(text);
+    if (text.empty()) return false;
+    size_t digit = (text[0] == '-') ? 1 : 0;
+    if (digit >= text.size()) return false;
+    char first = text[digit];
+    if (!((first >= '0' && first <= '9') || first == '.')) return false;
+    const char* end = text.data() + text.size();
+    auto result = std::from_chars(text.data(), end, out);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+inline std::uint64_t rotl64(std::uint64_t value, int shift) {
+    return (value << shift) | (value >> (64 - shift));
+}
+
+inline std::uint64_t mix64(std::uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+// Fast non-cryptographic 64-bit hash, eight bytes per step
+inline std::uint64_t hash_bytes(const void* data, size_t size, std::uint64_t seed = 0) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    std::uint64_t hash = seed ^ (static_cast<std::uint64_t>(size) * 0x9e3779b97f4a7c15ULL);
+
+    auto absorb = [&hash](std::uint64_t block) {
+        block *= 0x87c37b91114253d5ULL;
+        block = rotl64(block, 31);
+        block *= 0x4cf5ad432745937fULL;
+        hash ^= block;
+        hash = rotl64(hash, 27) * 5 + 0x52dce729;
+    };
+
+    while (size >= 8) {
+        std::uint64_t block;
+        std::memcpy(&block, bytes, 8);
+        absorb(block);
+        bytes += 8;
+        size -= 8;
+    }
+    if (size > 0) {
+        std::uint64_t block = 0;
+        std::memcpy(&block, bytes, size);
+        absorb(block);
+    }
+    return mix64(hash);
+}
+
+inline std::uint64_t hash_bytes(std::string_view text, std::uint64_t seed = 0) {
+    return hash_bytes(text.data(), text.size(), seed);
+}
+
+inline bool is_quoted(std::string_view text) {
+    return text.size() >= 2 &&
+           ((text.front() == '\'' && text.back() == '\'') ||
+            (text.front() == '"' && text.back() == '"'));
+}
+
+} // namespace detail
+
+// Kind of a raw value token
+enum class TokenKind { String, Int, Double, Bool, Array };
+
+namespace detail {
+
+// Result of classifying a trimmed scalar token
+struct Scalar {
+    TokenKind kind = TokenKind::String;
+    std::string_view text;  // Unquoted text for strings, the whole token otherwise
+    std::int64_t int_value = 0;
+    double double_value = 0.0;
+    bool bool_value = false;
+};
+
+// Walks an array body and calls fn(begin, end) for each top-level item.
+// Commas inside quotes or nested brackets do not split; returns false if a
+// ']' closes more than was opened.
+template <typename Fn>
+bool split_items(std::string_view body, Fn&& fn) {
+    size_t start = 0;
+    size_t depth = 0;
+    char quote = 0;
+    for (size_t i = 0; i < body.size(); ++i) {
+        char c = body[i];
+        if (quote) {
+            if (c == quote) quote = 0;
+        } else if (c == '\'' || c == '"') {
+            quote = c;
+        } else if (c == '[') {
+            ++depth;
+        } else if (c == ']') {
+            if (depth == 0) return false;
+            --depth;
+        } else if (c == ',' && depth == 0) {
+            fn(start, i);
+            start = i + 1;
+        }
+    }
+    fn(start, body.size());
+    return true;
+}
+
+// True if the token is one bracketed list whose opening '[' is closed by its
+// last character
+inline bool is_array_token(std::string_view token) {
+    if (token.size() < 2 || token.front() != '[' || token.back() != ']') return false;
+
+    size_t depth = 0;
+    char quote = 0;
+    for (size_t i = 0; i < token.size(); ++i) {
+        char c = token[i];
+        if (quote) {
+            if (c == quote) quote = 0;
+        } else if (c == '\'' || c == '"') {
+            quote = c;
+        } else if (c == '[') {
+            ++depth;
+        } else if (c == ']') {
+            if (--depth == 0) return i + 1 == token.size();
+        }
+    }
+    return false;
+}
+
+// Upper bound on the number of items in an array body, for reserving
+inline size_t count_items(std::string_view body) {
+    size_t count = 0;
+    split_items(body, [&](size_t, size_t) { ++count; });
+    return count;
+}
+
+// Calls fn for every non-empty, trimmed top-level item of an array body
+template <typename Fn>
+void for_each_item(std::string_view body, Fn&& fn) {
+    split_items(body, [&](size_t begin, size_t end) {
+        std::string_view item = trim(body.substr(begin, end - begin));
+        if (!item.empty()) fn(item);
+    });
+}
+
+// Works out the type of a trimmed value token without allocating or throwing
+inline Scalar classify_scalar(std::string_view token) {
+    Scalar scalar;
+    scalar.text = token;
+    if (token.empty()) return scalar;
+
+    if (is_quoted(token)) {
+        scalar.text = token.substr(1, token.size() - 2);
+        return scalar;
+    }
+    if (is_array_token(token)) {
+        scalar.kind = TokenKind::Array;
+        return scalar;
+    }
+    if (parse_bool(token, scalar.bool_value)) {
+        scalar.kind = TokenKind::Bool;
+        return scalar;
+    }
+
+    char first = token.front();
+    bool numeric_start = (first >= '0' && first <= '9') || first == '-' || first == '+' || first == '.';
+    if (!numeric_start) return scalar;
+
+    if (parse_int(token, scalar.int_value)) {
+        scalar.kind = TokenKind::Int;
+    } else if (token.find_first_of(".eE") != std::string_view::npos &&
+               parse_double(token, scalar.double_value)) {
+        scalar.kind = TokenKind::Double;
+    }
+    return scalar;
+}
+
+} // namespace detail
+
+// Unboxed storage for an array whose elements are all integers or all
+// doubles; parsed arrays use it when they qualify. The elements are
+// immutable and shared between copies. boxed() converts them to Values on
+// first use, for callers that need a std::vector<Value>.
+class PackedArray {
+private:
+    struct Storage;
+    std::shared_ptr<const Storage> storage_;
+
+public:
+    explicit PackedArray(std::vector<std::int64_t> ints);
+    explicit PackedArray(std::vector<double> doubles);
+
+    TokenKind kind() const;  // Int or Double
+    size_t size() const;
+
+    // Elements of the matching kind; the other accessor is empty
+    Span<const std::int64_t> ints() const;
+    Span<const double> doubles() const;
+
+    // The elements as Values. Built once, thread-safe
+    const std::vector<Value>& boxed() const;
+
+    friend bool operator==(const PackedArray& a, const PackedArray& b);
+    friend bool operator!=(const PackedArray& a, const PackedArray& b) { return !(a == b); }
+};
+
 // Value class to hold different types of values
 class Value {
 private:
     ValueType data_;
 
+    // Unsigned values above INT64_MAX would wrap, so they are rejected
+    template <typename Int>
+    static std::int64_t to_int64(Int value) {
+        if constexpr (std::is_unsigned_v<Int> && sizeof(Int) >= sizeof(std::int64_t)) {
+            if (value > static_cast<std::make_unsigned_t<std::int64_t>>(std::numeric_limits<std::int64_t>::max())) {
+                throw std::out_of_range("Integer value out of int64 range");
+            }
+        }
+        return static_cast<std::int64_t>(value);
+    }
+
 public:
     Value() : data_(std::string{}) {}
+    Value(const Value&) = default;
+    Value(Value&&) noexcept = default;
     Value(const std::string& value) : data_(value) {}
+    Value(std::string&& value) noexcept : data_(std::move(value)) {}
     Value(const char* value) : data_(std::string(value)) {}
-    Value(int value) : data_(value) {}
+    template <typename Int, std::enable_if_t<std::is_integral_v<Int> && !std::is_same_v<Int, bool>, int> = 0>
+    Value(Int value) : data_(to_int64(value)) {}
     Value(double value) : data_(value) {}
     Value(bool value) : data_(value) {}
     Value(const std::vector<Value>& value) : data_(value) {}
+    Value(std::vector<Value>&& value) noexcept : data_(std::move(value)) {}
+    Value(std::vector<std::int64_t> value) : data_(PackedArray(std::move(value))) {}
+    Value(std::vector<double> value) : data_(PackedArray(std::move(value))) {}
+    Value(PackedArray value) noexcept : data_(std::move(value)) {}
 
     // Type checking methods
     bool is_string() const { return std::holds_alternative<std::string>(data_); }
-    bool is_int() const { return std::holds_alternative<int>(data_); }
+    bool is_int() const { return std::holds_alternative<std::int64_t>(data_); }
     bool is_double() const { return std::holds_alternative<double>(data_); }
     bool is_bool() const { return std::holds_alternative<bool>(data_); }
-    bool is_array() const { return std::holds_alternative<std::vector<Value>>(data_); }
+    bool is_array() const {
+        return std::holds_alternative<std::vector<Value>>(data_) || std::holds_alternative<PackedArray>(data_);
+    }
 
     // Getters with type conversion
     std::string as_string() const {
         if (is_string()) return std::get<std::string>(data_);
-        if (is_int()) return std::to_string(std::get<int>(data_));
+        if (is_int()) return std::to_string(std::get<std::int64_t>(data_));
         if (is_double()) return std::to_string(std::get<double>(data_));
         if (is_bool()) return std::get<bool>(data_) ? "true" : "false";
         throw std::runtime_error("Cannot convert array to string");
     }
 
     int as_int() const {
-        if (is_int()) return std::get<int>(data_);
+        if (is_int()) {
+            std::int64_t value = std::get<std::int64_t>(data_);
+            if (value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max()) {
+                throw std::out_of_range("Integer value out of int range");
+            }
+            return static_cast<int>(value);
+        }
         if (is_double()) return static_cast<int>(std::get<double>(data_));
         if (is_string()) {
-            try {
-                return std::stoi(std::get<std::string>(data_));
-            } catch (...) {
-                throw std::runtime_error("Cannot convert string to int");
-            }
+            int result = 0;
+            if (detail::parse_int(detail::trim(std::get<std::string>(data_)), result)) return result;
+            throw std::runtime_error("Cannot convert string to int");
+        }
+        throw std::runtime_error("Cannot convert to int");
+    }
+
+    std::int64_t as_int64() const {
+        if (is_int()) return std::get<std::int64_t>(data_);
+        if (is_double()) return static_cast<std::int64_t>(std::get<double>(data_));
+        if (is_string()) {
+            std::int64_t result = 0;
+            if (detail::parse_int(detail::trim(std::get<std::string>(data_)), result)) return result;
+            throw std::runtime_error("Cannot convert string to int");
         }
         throw std::runtime_error("Cannot convert to int");
     }
 
     double as_double() const {
         if (is_double()) return std::get<double>(data_);
-        if (is_int()) return static_cast<double>(std::get<int>(data_));
+        if (is_int()) return static_cast<double>(std::get<std::int64_t>(data_));
         if (is_string()) {
-            try {
-                return std::stod(std::get<std::string>(data_));
-            } catch (...) {
-                throw std::runtime_error("Cannot convert string to double");
-            }
+            std::string_view text = detail::trim(std::get<std::string>(data_));
+            double result = 0.0;
+            if (detail::parse_double(text, result)) return result;
+            throw std::runtime_error("Cannot convert string to double");
         }
         throw std::runtime_error("Cannot convert to double");
     }
@@ -91,333 +469,4067 @@ public:
     bool as_bool() const {
         if (is_bool()) return std::get<bool>(data_);
         if (is_string()) {
-            std::string str = std::get<std::string>(data_);
-            std::transform(str.begin(), str.end(), str.begin(), ::tolower);
-            return str == "true" || str == "yes" || str == "on" || str == "1";
+            const std::string& str = std::get<std::string>(data_);
+            return detail::iequals(str, "true") || detail::iequals(str, "yes") ||
+                   detail::iequals(str, "on") || str == "1";
         }
-        if (is_int()) return std::get<int>(data_) != 0;
+        if (is_int()) return std::get<std::int64_t>(data_) != 0;
         throw std::runtime_error("Cannot convert to bool");
     }
 
     std::vector<Value> as_array() const {
-        if (is_array()) return std::get<std::vector<Value>>(data_);
+        if (is_array()) return array_ref();
         throw std::runtime_error("Value is not an array");
     }
 
+    // Non-copying access
+    std::string_view as_string_view() const {
+        if (const std::string* str = std::get_if<std::string>(&data_)) return *str;
+        throw std::runtime_error("Value is not a string");
+    }
+
+    // Packed arrays are boxed on first use; the mutable overload converts
+    // the value to a plain array
+    const std::vector<Value>& array_ref() const {
+        if (const std::vector<Value>* array = std::get_if<std::vector<Value>>(&data_)) return *array;
+        if (const PackedArray* packed = std::get_if<PackedArray>(&data_)) return packed->boxed();
+        throw std::runtime_error("Value is not an array");
+    }
+
+    std::vector<Value>& array_ref() {
+        if (const PackedArray* packed = std::get_if<PackedArray>(&data_)) {
+            std::vector<Value> unpacked = packed->boxed();
+            data_ = std::move(unpacked);
+        }
+        if (std::vector<Value>* array = std::get_if<std::vector<Value>>(&data_)) return *array;
+        throw std::runtime_error("Value is not an array");
+    }
+
+    // Contiguous elements of a packed integer or double array
+    Span<const std::int64_t> int_span() const {
+        const PackedArray* packed = std::get_if<PackedArray>(&data_);
+        if (packed && packed->kind() == TokenKind::Int) return packed->ints();
+        if (is_empty_array()) return {};
+        throw std::runtime_error("Value is not a packed integer array");
+    }
+
+    Span<const double> double_span() const {
+        const PackedArray* packed = std::get_if<PackedArray>(&data_);
+        if (packed && packed->kind() == TokenKind::Double) return packed->doubles();
+        if (is_empty_array()) return {};
+        throw std::runtime_error("Value is not a packed double array");
+    }
+
+    // An empty array has no element kind; both spans accept it
+    bool is_empty_array() const {
+        if (const PackedArray* packed = std::get_if<PackedArray>(&data_)) return packed->size() == 0;
+        const std::vector<Value>* items = std::get_if<std::vector<Value>>(&data_);
+        return items && items->empty();
+    }
+
+    // Pointer to the held alternative, or nullptr if T is not the held type
+    template <typename T>
+    const T* get_if() const noexcept { return std::get_if<T>(&data_); }
+
+    template <typename T>
+    T* get_if() noexcept { return std::get_if<T>(&data_); }
+
+    // std::visit over the held alternative
+    template <typename Fn>
+    decltype(auto) visit(Fn&& fn) const {
+        return std::visit(std::forward<Fn>(fn), data_);
+    }
+
+    template <typename Fn>
+    decltype(auto) visit(Fn&& fn) {
+        return std::visit(std::forward<Fn>(fn), data_);
+    }
+
     // Operators for easy assignment
+    Value& operator=(const Value&) = default;
+    Value& operator=(Value&&) noexcept = default;
     Value& operator=(const std::string& value) { data_ = value; return *this; }
+    Value& operator=(std::string&& value) { data_ = std::move(value); return *this; }
     Value& operator=(const char* value) { data_ = std::string(value); return *this; }
-    Value& operator=(int value) { data_ = value; return *this; }
+    template <typename Int, std::enable_if_t<std::is_integral_v<Int> && !std::is_same_v<Int, bool>, int> = 0>
+    Value& operator=(Int value) { data_ = to_int64(value); return *this; }
     Value& operator=(double value) { data_ = value; return *this; }
     Value& operator=(bool value) { data_ = value; return *this; }
     Value& operator=(const std::vector<Value>& value) { data_ = value; return *this; }
+    Value& operator=(std::vector<Value>&& value) { data_ = std::move(value); return *this; }
+    Value& operator=(std::vector<std::int64_t> value) { data_ = PackedArray(std::move(value)); return *this; }
+    Value& operator=(std::vector<double> value) { data_ = PackedArray(std::move(value)); return *this; }
+
+    // Same type and same content; no conversions are applied. Packed and
+    // plain arrays with the same elements are equal.
+    friend bool operator==(const Value& a, const Value& b) {
+        if (a.data_.index() != b.data_.index() && a.is_array() && b.is_array()) {
+            return a.array_ref() == b.array_ref();
+        }
+        return a.data_ == b.data_;
+    }
+    friend bool operator!=(const Value& a, const Value& b) { return !(a == b); }
 };
 
-// Section class to represent nested sections
-class Section {
-private:
-    std::unordered_map<std::string, Value> values_;
-    std::unordered_map<std::string, std::unique_ptr<Section>> subsections_;
+struct PackedArray::Storage {
+    TokenKind kind = TokenKind::Int;
+    std::vector<std::int64_t> ints;
+    std::vector<double> doubles;
+    mutable std::once_flag boxed_once;
+    mutable std::vector<Value> boxed;
+};
+
+inline PackedArray::PackedArray(std::vector<std::int64_t> ints) {
+    auto storage = std::make_shared<Storage>();
+    storage->kind = TokenKind::Int;
+    storage->ints = std::move(ints);
+    storage_ = std::move(storage);
+}
+
+inline PackedArray::PackedArray(std::vector<double> doubles) {
+    auto storage = std::make_shared<Storage>();
+    storage->kind = TokenKind::Double;
+    storage->doubles = std::move(doubles);
+    storage_ = std::move(storage);
+}
+
+inline TokenKind PackedArray::kind() const { return storage_->kind; }
+
+inline size_t PackedArray::size() const {
+    return storage_->kind == TokenKind::Int ? storage_->ints.size() : storage_->doubles.size();
+}
 
+inline Span<const std::int64_t> PackedArray::ints() const {
+    return Span<const std::int64_t>(storage_->ints.data(), storage_->ints.size());
+}
+
+inline Span<const double> PackedArray::doubles() const {
+    return Span<const double>(storage_->doubles.data(), storage_->doubles.size());
+}
+
+inline const std::vector<Value>& PackedArray::boxed() const {
+    const Storage& storage = *storage_;
+    std::call_once(storage.boxed_once, [&storage]() {
+        storage.boxed.reserve(storage.ints.size() + storage.doubles.size());
+        for (std::int64_t number : storage.ints) storage.boxed.emplace_back(number);
+        for (double real : storage.doubles) storage.boxed.emplace_back(real);
+    });
+    return storage.boxed;
+}
+
+inline bool operator==(const PackedArray& a, const PackedArray& b) {
+    return a.storage_ == b.storage_ ||
+           (a.storage_->kind == b.storage_->kind && a.storage_->ints == b.storage_->ints &&
+            a.storage_->doubles == b.storage_->doubles);
+}
+
+namespace detail {
+
+// Insertion-ordered map from std::string keys with heterogeneous lookup.
+// Entries live in a deque, so references stay valid as the map grows, and
+// an open-addressing index of cached hashes maps keys to entry positions.
+template <typename T>
+class StringMap {
 public:
-    // Value access
-    Value& operator[](const std::string& key) {
-        return values_[key];
+    using value_type = std::pair<std::string, T>;
+    using iterator = typename std::deque<value_type>::iterator;
+    using const_iterator = typename std::deque<value_type>::const_iterator;
+
+private:
+    struct Slot {
+        std::uint64_t hash = 0;
+        std::uint32_t index = 0;  // Entry position + 1; 0 marks an empty slot
+    };
+
+    std::deque<value_type> entries_;
+    std::vector<Slot> slots_;
+
+    size_t probe(std::string_view key, std::uint64_t hash) const {
+        size_t mask = slots_.size() - 1;
+        for (size_t pos = static_cast<size_t>(hash) & mask;; pos = (pos + 1) & mask) {
+            const Slot& slot = slots_[pos];
+            if (slot.index == 0) return pos;
+            if (slot.hash == hash && entries_[slot.index - 1].first == key) return pos;
+        }
     }
 
-    const Value& at(const std::string& key) const {
-        auto it = values_.find(key);
-        if (it == values_.end()) {
-            throw std::out_of_range("Key not found: " + key);
+    void grow() {
+        std::vector<Slot> old = std::move(slots_);
+        slots_.assign(old.empty() ? 16 : old.size() * 2, Slot{});
+        size_t mask = slots_.size() - 1;
+        for (const Slot& slot : old) {
+            if (slot.index == 0) continue;
+            size_t pos = static_cast<size_t>(slot.hash) & mask;
+            while (slots_[pos].index != 0) pos = (pos + 1) & mask;
+            slots_[pos] = slot;
         }
-        return it->second;
     }
 
-    bool has_value(const std::string& key) const {
-        return values_.find(key) != values_.end();
+public:
+    T* find(std::string_view key, std::uint64_t hash) {
+        return const_cast<T*>(static_cast<const StringMap&>(*this).find(key, hash));
     }
 
-    // Section access
-    Section& section(const std::string& name) {
-        if (subsections_.find(name) == subsections_.end()) {
-            subsections_[name] = std::make_unique<Section>();
-        }
-        return *subsections_[name];
+    const T* find(std::string_view key, std::uint64_t hash) const {
+        if (slots_.empty()) return nullptr;
+        const Slot& slot = slots_[probe(key, hash)];
+        return slot.index == 0 ? nullptr : &entries_[slot.index - 1].second;
     }
 
-    const Section& get_section(const std::string& name) const {
-        auto it = subsections_.find(name);
-        if (it == subsections_.end()) {
-            throw std::out_of_range("Section not found: " + name);
+    T* find(std::string_view key) { return find(key, hash_bytes(key)); }
+    const T* find(std::string_view key) const { return find(key, hash_bytes(key)); }
+
+    // Inserts a value-initialised entry if the key is missing
+    std::pair<T*, bool> try_emplace(std::string_view key, std::uint64_t hash) {
+        if ((entries_.size() + 1) * 2 > slots_.size()) grow();
+        Slot& slot = slots_[probe(key, hash)];
+        if (slot.index != 0) return {&entries_[slot.index - 1].second, false};
+
+        if (entries_.size() >= std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("Too many entries in section");
         }
-        return *it->second;
+        entries_.emplace_back(std::string(key), T());
+        slot.hash = hash;
+        slot.index = static_cast<std::uint32_t>(entries_.size());
+        return {&entries_.back().second, true};
     }
 
-    bool has_section(const std::string& name) const {
-        return subsections_.find(name) != subsections_.end();
+    std::pair<T*, bool> try_emplace(std::string_view key) { return try_emplace(key, hash_bytes(key)); }
+
+    T& operator[](std::string_view key) { return *try_emplace(key).first; }
+
+    // Removes an entry, keeping the order of the rest. Erasing from the middle
+    // of a deque invalidates every reference and iterator into it, and the
+    // index is rebuilt, so erase is O(n).
+    bool erase(std::string_view key) {
+        if (slots_.empty()) return false;
+        const Slot& slot = slots_[probe(key, hash_bytes(key))];
+        if (slot.index == 0) return false;
+
+        entries_.erase(entries_.begin() + static_cast<std::ptrdiff_t>(slot.index - 1));
+        std::fill(slots_.begin(), slots_.end(), Slot{});
+        size_t mask = slots_.size() - 1;
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            std::uint64_t hash = hash_bytes(entries_[i].first);
+            size_t pos = static_cast<size_t>(hash) & mask;
+            while (slots_[pos].index != 0) pos = (pos + 1) & mask;
+            slots_[pos] = Slot{hash, static_cast<std::uint32_t>(i + 1)};
+        }
+        return true;
     }
 
-    // Iterators for values
-    auto values_begin() const { return values_.begin(); }
-    auto values_end() const { return values_.end(); }
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
 
-    // Iterators for sections
-    auto sections_begin() const { return subsections_.begin(); }
-    auto sections_end() const { return subsections_.end(); }
+    iterator begin() { return entries_.begin(); }
+    iterator end() { return entries_.end(); }
+    const_iterator begin() const { return entries_.begin(); }
+    const_iterator end() const { return entries_.end(); }
 
-    // Clear all data
     void clear() {
-        values_.clear();
-        subsections_.clear();
+        entries_.clear();
+        slots_.clear();
     }
 };
 
-// Main YINI parser/writer class
-class Parser {
+} // namespace detail
+
+// Dotted path ("server.auth.user") split and hashed once by compile_path();
+// the last segment names a value, the others name sections
+class Path {
+public:
+    struct Segment {
+        std::string name;
+        std::uint64_t hash = 0;
+    };
+
+    Path() = default;
+
+    const std::vector<Segment>& segments() const { return segments_; }
+    bool empty() const { return segments_.empty(); }
+
 private:
-    Section root_;
+    friend Path compile_path(std::string_view dotted);
+    std::vector<Segment> segments_;
+};
 
-    // Helper functions
-    std::string trim(const std::string& str) {
-        size_t start = str.find_first_not_of(" \t\r\n");
-        if (start == std::string::npos) return "";
-        size_t end = str.find_last_not_of(" \t\r\n");
-        return str.substr(start, end - start + 1);
+inline Path compile_path(std::string_view dotted) {
+    Path path;
+    size_t start = 0;
+    while (true) {
+        size_t dot = dotted.find('.', start);
+        std::string_view name = dotted.substr(start, dot == std::string_view::npos ? dot : dot - start);
+        path.segments_.push_back(Path::Segment{std::string(name), detail::hash_bytes(name)});
+        if (dot == std::string_view::npos) break;
+        start = dot + 1;
     }
+    return path;
+}
 
-    std::string remove_multiline_comments(const std::string& content) {
-        std::string result = content;
-        size_t start = 0;
-        
-        while ((start = result.find("/*", start)) != std::string::npos) {
-            size_t end = result.find("*/", start + 2);
-            if (end == std::string::npos) {
-                // Unclosed multiline comment - remove everything from start
-                result = result.substr(0, start);
-                break;
-            }
-            // Remove the comment including the delimiters
-            result.erase(start, end - start + 2);
-        }
-        
-        return result;
+namespace detail {
+
+struct AtomEntry {
+    std::string text;
+    std::uint64_t hash = 0;
+};
+
+} // namespace detail
+
+// Interned key. The text is stored once in a process-wide table and its
+// hash is computed once. Equal texts intern to the same entry, so
+// comparing two atoms is a pointer compare. Section lookups with an atom
+// only skip rehashing the key; the probe still compares the text against
+// the stored key, since sections keep their keys as strings.
+//
+// The table is never pruned and grows for the life of the process, so do
+// not intern keys taken from untrusted documents.
+class Atom {
+private:
+    friend Atom intern(std::string_view text);
+
+    const detail::AtomEntry* entry_;
+
+    explicit Atom(const detail::AtomEntry* entry) : entry_(entry) {}
+
+    static const detail::AtomEntry* empty_entry() {
+        static const detail::AtomEntry entry{std::string(), detail::hash_bytes(std::string_view())};
+        return &entry;
     }
 
-    std::string remove_line_comments(const std::string& line) {
-        size_t comment_pos = line.find("//");
-        if (comment_pos != std::string::npos) {
-            return line.substr(0, comment_pos);
-        }
-        return line;
+public:
+    Atom() : entry_(empty_entry()) {}
+
+    std::string_view str() const { return entry_->text; }
+    std::uint64_t hash() const { return entry_->hash; }
+
+    friend bool operator==(Atom a, Atom b) { return a.entry_ == b.entry_; }
+    friend bool operator!=(Atom a, Atom b) { return a.entry_ != b.entry_; }
+};
+
+namespace detail {
+
+class AtomTable {
+private:
+    std::mutex mutex_;
+    std::deque<AtomEntry> entries_;  // Stable addresses
+    StringMap<const AtomEntry*> index_;
+
+public:
+    static AtomTable& instance() {
+        static AtomTable table;
+        return table;
     }
 
-    int count_carets(const std::string& line) {
-        int count = 0;
-        for (char c : line) {
-            if (c == '^') count++;
-            else break;
+    const AtomEntry* intern(std::string_view text) {
+        std::uint64_t hash = hash_bytes(text);
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto [slot, inserted] = index_.try_emplace(text, hash);
+        if (inserted) {
+            entries_.push_back(AtomEntry{std::string(text), hash});
+            *slot = &entries_.back();
         }
-        return count;
+        return *slot;
     }
 
-    Value parse_value(const std::string& value_str) {
-        std::string trimmed = trim(value_str);
-        
-        // Handle quoted strings
-        if ((trimmed.front() == '\'' && trimmed.back() == '\'') ||
-            (trimmed.front() == '"' && trimmed.back() == '"')) {
-            return Value(trimmed.substr(1, trimmed.length() - 2));
-        }
-
-        // Handle arrays (lists)
-        if (trimmed.front() == '[' && trimmed.back() == ']') {
-            std::vector<Value> array;
-            std::string content = trimmed.substr(1, trimmed.length() - 2);
-            std::stringstream ss(content);
-            std::string item;
-            
-            while (std::getline(ss, item, ',')) {
-                item = trim(item);
-                if (!item.empty()) {
-                    array.push_back(parse_value(item));
-                }
-            }
-            return Value(array);
-        }
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+};
 
-        // Handle boolean values
-        std::string lower = trimmed;
-        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
-        if (lower == "true" || lower == "yes" || lower == "on") {
-            return Value(true);
-        }
-        if (lower == "false" || lower == "no" || lower == "off") {
-            return Value(false);
-        }
+} // namespace detail
 
-        // Handle numeric values
-        try {
-            if (trimmed.find('.') != std::string::npos) {
-                return Value(std::stod(trimmed));
-            } else {
-                return Value(std::stoi(trimmed));
-            }
-        } catch (...) {
-            // If not a number, treat as string
-            return Value(trimmed);
+// Intern a key; takes a lock, so keep atoms around rather than interning
+// on every lookup. Each distinct text stays in the table until exit.
+inline Atom intern(std::string_view text) {
+    if (text.empty()) return Atom();
+    return Atom(detail::AtomTable::instance().intern(text));
+}
+
+inline size_t interned_count() { return detail::AtomTable::instance().size(); }
+
+// Section class to represent nested sections
+class Section {
+public:
+    // A stored subsection. Subtrees may be shared between trees, so they
+    // are handed out read-only; it converts to shared_ptr<const Section>.
+    class Subtree {
+    private:
+        friend class Section;
+
+        std::shared_ptr<const Section> tree_;
+        Section* mutable_ = nullptr;  // Set only for subtrees held as non-const objects
+
+        Subtree(std::shared_ptr<Section> tree) : mutable_(tree.get()) { tree_ = std::move(tree); }
+        Subtree(std::shared_ptr<const Section> tree) : tree_(std::move(tree)) {}
+
+        // Only this slot holds it and it may be modified in place
+        bool unique() const { return mutable_ && tree_.use_count() == 1; }
+
+    public:
+        Subtree() = default;
+
+        const Section* get() const noexcept { return tree_.get(); }
+        const Section& operator*() const noexcept { return *tree_; }
+        const Section* operator->() const noexcept { return tree_.get(); }
+        operator const std::shared_ptr<const Section>&() const noexcept { return tree_; }
+
+        friend bool operator==(const Subtree& a, const Subtree& b) { return a.tree_ == b.tree_; }
+        friend bool operator!=(const Subtree& a, const Subtree& b) { return a.tree_ != b.tree_; }
+    };
+
+private:
+    detail::StringMap<Value> values_;
+    detail::StringMap<Subtree> subsections_;
+
+    // Copy-on-write: a subtree referenced from elsewhere, or one attached
+    // as const, is cloned before it is handed out for modification. This
+    // is the only place a stored subtree becomes mutable.
+    static Section& detach(Subtree& slot) {
+        if (!slot.unique()) {
+            slot = Subtree(std::make_shared<Section>(slot->clone()));
         }
+        return *slot.mutable_;
     }
 
-    Section* navigate_to_section(const std::vector<std::string>& section_path) {
-        Section* current = &root_;
-        for (const auto& section_name : section_path) {
-            current = &current->section(section_name);
+    Section& open_section(std::string_view name, std::uint64_t hash) {
+        auto [slot, inserted] = subsections_.try_emplace(name, hash);
+        if (inserted) {
+            *slot = Subtree(std::make_shared<Section>());
+            return *slot->mutable_;
         }
-        return current;
+        return detach(*slot);
     }
 
-    void write_section(std::ostream& out, const Section& section, 
-                      const std::vector<std::string>& path, int indent_level = 0) {
-        // Write section header if not root
-        if (!path.empty()) {
-            out << std::string(indent_level * 4, ' ') 
-                << std::string(indent_level + 1, '^') << ' ' 
-                << path.back() << '\n';
-        }
+public:
+    Section() = default;
+    Section(Section&&) = default;
+    Section& operator=(Section&&) = default;
 
-        // Write values
-        for (auto it = section.values_begin(); it != section.values_end(); ++it) {
-            out << std::string((indent_level + (path.empty() ? 0 : 1)) * 4, ' ');
-            out << it->first << " = ";
-            write_value(out, it->second);
-            out << '\n';
-        }
+    // Copies are explicit; see clone()
+    Section(const Section&) = delete;
+    Section& operator=(const Section&) = delete;
 
-        // Write subsections
-        for (auto it = section.sections_begin(); it != section.sections_end(); ++it) {
-            if (!path.empty() || it != section.sections_begin()) {
-                out << '\n';
-            }
-            
-            std::vector<std::string> new_path = path;
-            new_path.push_back(it->first);
-            write_section(out, *it->second, new_path, indent_level + (path.empty() ? 0 : 1));
-        }
+    // Copy this section's values and share its subsections. Shared
+    // subtrees are cloned lazily, level by level, when either tree
+    // modifies them through section() or merge(). Sharing is detected
+    // with use_count(), so a tree and its clones must not be modified
+    // while another thread uses any of them; hand each thread its clone
+    // before either side starts writing.
+    Section clone() const {
+        Section copy;
+        copy.values_ = values_;
+        copy.subsections_ = subsections_;
+        return copy;
     }
 
-    void write_value(std::ostream& out, const Value& value) {
-        if (value.is_string()) {
-            out << '\'' << value.as_string() << '\'';
-        } else if (value.is_bool()) {
-            out << (value.as_bool() ? "true" : "false");
-        } else if (value.is_array()) {
-            out << '[';
-            auto array = value.as_array();
-            for (size_t i = 0; i < array.size(); ++i) {
-                if (i > 0) out << ", ";
-                write_value(out, array[i]);
-            }
-            out << ']';
-        } else {
-            out << value.as_string();
+    // Value access
+    Value& operator[](std::string_view key) {
+        return values_[key];
+    }
+
+    const Value& at(std::string_view key) const {
+        const Value* value = values_.find(key);
+        if (!value) {
+            throw std::out_of_range("Key not found: " + std::string(key));
         }
+        return *value;
     }
 
-public:
-    Parser() = default;
+    bool has_value(std::string_view key) const {
+        return values_.find(key) != nullptr;
+    }
 
-    // Parse from file
-    void parse_file(const std::string& filename) {
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            throw FileError("Cannot open file: " + filename);
+    // Direct lookup; unlike find(), key is not split on '.'
+    const Value* find_value(std::string_view key) const {
+        return values_.find(key);
+    }
+
+    // Same lookups with an interned key; its stored hash is reused
+    Value& operator[](Atom key) {
+        return *values_.try_emplace(key.str(), key.hash()).first;
+    }
+
+    const Value* find_value(Atom key) const {
+        return values_.find(key.str(), key.hash());
+    }
+
+    const Value& at(Atom key) const {
+        const Value* value = find_value(key);
+        if (!value) {
+            throw std::out_of_range("Key not found: " + std::string(key.str()));
         }
+        return *value;
+    }
+
+    bool has_value(Atom key) const { return find_value(key) != nullptr; }
 
-        std::string content((std::istreambuf_iterator<char>(file)),
-                           std::istreambuf_iterator<char>());
-        parse_string(content);
+    const Section* find_section(Atom name) const {
+        const Subtree* slot = subsections_.find(name.str(), name.hash());
+        return slot ? slot->get() : nullptr;
     }
 
-    // Parse from string
-    void parse_string(const std::string& content) {
-        root_.clear();
-        
-        // First, remove all multiline comments
-        std::string cleaned_content = remove_multiline_comments(content);
-        
-        std::vector<std::string> section_stack;
-        std::istringstream stream(cleaned_content);
-        std::string line;
-        int line_number = 0;
-
-        while (std::getline(stream, line)) {
-            line_number++;
-            line = remove_line_comments(line);
-            line = trim(line);
+    // Section access
+    Section& section(std::string_view name) { return open_section(name, detail::hash_bytes(name)); }
+    Section& section(Atom name) { return open_section(name.str(), name.hash()); }
 
-            if (line.empty()) continue;
+    // Insert an existing subtree under name, replacing any section already
+    // there. The subtree is shared, not copied, and is cloned before this
+    // tree modifies it while shared. A non-const subtree is modified in
+    // place once this tree is its only owner; a const one is always cloned
+    // before its first modification.
+    void attach(std::string_view name, std::shared_ptr<Section> subtree) {
+        if (!subtree) subtree = std::make_shared<Section>();
+        *subsections_.try_emplace(name).first = Subtree(std::move(subtree));
+    }
 
-            try {
-                int caret_count = count_carets(line);
-                
-                if (caret_count > 0) {
-                    // This is a section header
-                    std::string section_name = trim(line.substr(caret_count));
-                    
-                    // Adjust section stack to match nesting level
-                    section_stack.resize(caret_count - 1);
-                    section_stack.push_back(section_name);
-                } else {
-                    // This is a key-value pair
-                    size_t equals_pos = line.find('=');
-                    if (equals_pos == std::string::npos) {
-                        throw ParseError("Invalid line format at line " + std::to_string(line_number) + ": " + line);
-                    }
+    void attach(std::string_view name, std::shared_ptr<const Section> subtree) {
+        if (!subtree) subtree = std::make_shared<Section>();
+        *subsections_.try_emplace(name).first = Subtree(std::move(subtree));
+    }
+
+    const Section* find_section(std::string_view name) const {
+        const Subtree* slot = subsections_.find(name);
+        return slot ? slot->get() : nullptr;
+    }
 
-                    std::string key = trim(line.substr(0, equals_pos));
-                    std::string value_str = trim(line.substr(equals_pos + 1));
+    const Section& get_section(std::string_view name) const {
+        const Section* section = find_section(name);
+        if (!section) {
+            throw std::out_of_range("Section not found: " + std::string(name));
+        }
+        return *section;
+    }
 
-                    if (key.empty()) {
-                        throw ParseError("Empty key at line " + std::to_string(line_number) + ": " + line);
-                    }
+    bool has_section(std::string_view name) const {
+        return find_section(name) != nullptr;
+    }
 
-                    Section* target_section = navigate_to_section(section_stack);
-                    (*target_section)[key] = parse_value(value_str);
-                }
-            } catch (const std::exception& e) {
-                throw ParseError("Error at line " + std::to_string(line_number) + ": " + e.what());
+    // Dotted-path lookup ("server.auth.user"); never inserts or allocates.
+    // Returns nullptr if any segment is missing.
+    const Value* find(std::string_view path) const {
+        const Section* current = this;
+        size_t start = 0;
+        while (true) {
+            size_t dot = path.find('.', start);
+            if (dot == std::string_view::npos) {
+                return current->values_.find(path.substr(start));
             }
+            current = current->find_section(path.substr(start, dot - start));
+            if (!current) return nullptr;
+            start = dot + 1;
         }
     }
 
-    // Write to file
-    void write_file(const std::string& filename) {
-        std::ofstream file(filename);
-        if (!file.is_open()) {
-            throw FileError("Cannot write to file: " + filename);
+    // Lookup with a precompiled path; segment hashes are reused
+    const Value* find(const Path& path) const {
+        const auto& segments = path.segments();
+        if (segments.empty()) return nullptr;
+
+        const Section* current = this;
+        for (size_t i = 0; i + 1 < segments.size(); ++i) {
+            const Subtree* slot = current->subsections_.find(segments[i].name, segments[i].hash);
+            if (!slot) return nullptr;
+            current = slot->get();
         }
-        write_stream(file);
+        return current->values_.find(segments.back().name, segments.back().hash);
     }
 
-    // Write to string
-    std::string write_string() {
-        std::ostringstream oss;
-        write_stream(oss);
-        return oss.str();
-    }
+    // Remove a value or subsection; the order of the others is kept.
+    // References to this section's values, and iterators over it, are
+    // invalidated; subsections themselves do not move.
+    bool erase_value(std::string_view key) { return values_.erase(key); }
+    bool erase_section(std::string_view name) { return subsections_.erase(name); }
 
-    // Write to stream
-    void write_stream(std::ostream& out) {
-        write_section(out, root_, {});
+    size_t value_count() const { return values_.size(); }
+    size_t section_count() const { return subsections_.size(); }
+
+    // Merge another tree into this one: values from other override, and
+    // subsections present in both are merged recursively
+    void merge(Section&& other) {
+        for (auto& entry : other.values_) {
+            values_[entry.first] = std::move(entry.second);
+        }
+        for (auto& entry : other.subsections_) {
+            auto [slot, inserted] = subsections_.try_emplace(entry.first);
+            if (inserted) {
+                *slot = std::move(entry.second);
+            } else if (!entry.second.unique()) {
+                detach(*slot).merge(*entry.second);
+            } else {
+                detach(*slot).merge(std::move(detach(entry.second)));
+            }
+        }
+        other.clear();
+    }
+
+    // Overlay variant that leaves other intact; subsections only other has
+    // are shared rather than copied, so the cost follows the size of other
+    void merge(const Section& other) {
+        for (const auto& entry : other.values_) {
+            values_[entry.first] = entry.second;
+        }
+        for (const auto& entry : other.subsections_) {
+            auto [slot, inserted] = subsections_.try_emplace(entry.first);
+            if (inserted) {
+                *slot = entry.second;
+            } else if (*slot != entry.second) {
+                detach(*slot).merge(*entry.second);
+            }
+        }
+    }
+
+    // Iterators for values, in insertion order
+    auto values_begin() const { return values_.begin(); }
+    auto values_end() const { return values_.end(); }
+
+    // Iterators for sections, in insertion order. Subtrees are reached as
+    // read-only Subtree handles; modify them through section().
+    auto sections_begin() const { return subsections_.begin(); }
+    auto sections_end() const { return subsections_.end(); }
+
+    // Clear all data
+    void clear() {
+        values_.clear();
+        subsections_.clear();
+    }
+};
+
+namespace detail {
+
+// Branch-free lower bound over a sorted key array; returns count when the
+// key is absent
+inline size_t sorted_find(const std::string_view* keys, size_t count, std::string_view key) {
+    if (count == 0) return 0;
+    const std::string_view* base = keys;
+    size_t remaining = count;
+    while (remaining > 1) {
+        size_t half = remaining / 2;
+        base = (base[half - 1] < key) ? base + half : base;
+        remaining -= half;
+    }
+    size_t index = static_cast<size_t>(base - keys) + (*base < key ? 1 : 0);
+    return (index < count && keys[index] == key) ? index : count;
+}
+
+} // namespace detail
+
+class FrozenDocument;
+
+// Immutable view of a section inside a FrozenDocument. Keys are kept in
+// sorted flat arrays next to their values, so lookups are a binary search
+// over contiguous memory and never allocate.
+class FrozenSection {
+private:
+    friend class FrozenDocument;
+
+    std::string_view name_;
+    const std::string_view* keys_ = nullptr;
+    const Value* values_ = nullptr;
+    size_t value_count_ = 0;
+    const std::string_view* section_names_ = nullptr;
+    const FrozenSection* sections_ = nullptr;
+    size_t section_count_ = 0;
+
+public:
+    std::string_view name() const { return name_; }
+
+    // Value access; find() returns nullptr when absent
+    const Value* find(std::string_view key) const {
+        size_t index = detail::sorted_find(keys_, value_count_, key);
+        return index < value_count_ ? values_ + index : nullptr;
+    }
+
+    const Value& at(std::string_view key) const {
+        const Value* value = find(key);
+        if (!value) {
+            throw std::out_of_range("Key not found: " + std::string(key));
+        }
+        return *value;
+    }
+
+    bool has_value(std::string_view key) const { return find(key) != nullptr; }
+
+    // Section access
+    const FrozenSection* find_section(std::string_view name) const {
+        size_t index = detail::sorted_find(section_names_, section_count_, name);
+        return index < section_count_ ? sections_ + index : nullptr;
+    }
+
+    const FrozenSection& get_section(std::string_view name) const {
+        const FrozenSection* section = find_section(name);
+        if (!section) {
+            throw std::out_of_range("Section not found: " + std::string(name));
+        }
+        return *section;
+    }
+
+    bool has_section(std::string_view name) const { return find_section(name) != nullptr; }
+
+    // Parallel arrays, sorted by key
+    Span<const std::string_view> keys() const { return Span<const std::string_view>(keys_, value_count_); }
+    Span<const Value> values() const { return Span<const Value>(values_, value_count_); }
+    Span<const std::string_view> section_names() const {
+        return Span<const std::string_view>(section_names_, section_count_);
+    }
+    Span<const FrozenSection> sections() const { return Span<const FrozenSection>(sections_, section_count_); }
+};
+
+// Read-only snapshot of a Section tree. All keys live in one string pool,
+// all values in one array and every section's children are adjacent, so a
+// frozen document is a handful of allocations and can be shared between
+// threads without locking. Moving keeps every view valid.
+class FrozenDocument {
+private:
+    std::unique_ptr<char[]> strings_;
+    std::vector<std::string_view> keys_;
+    std::vector<Value> values_;
+    std::vector<FrozenSection> sections_;  // Breadth first; sections_[0] is the root
+
+    struct Node {
+        const Section* section;
+        std::string_view name;
+        size_t first_child = 0;
+        size_t child_count = 0;
+    };
+
+public:
+    FrozenDocument() : sections_(1) {}
+
+    explicit FrozenDocument(const Section& root) {
+        using ValueEntry = std::pair<std::string_view, const Value*>;
+
+        // Breadth-first layout with each section's children sorted by name
+        std::vector<Node> nodes{Node{&root, std::string_view()}};
+        size_t value_count = 0;
+        size_t string_bytes = 0;
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            const Section& section = *nodes[i].section;
+            for (auto it = section.values_begin(); it != section.values_end(); ++it) {
+                ++value_count;
+                string_bytes += it->first.size();
+            }
+
+            size_t first = nodes.size();
+            for (auto it = section.sections_begin(); it != section.sections_end(); ++it) {
+                nodes.push_back(Node{it->second.get(), it->first});
+                string_bytes += it->first.size();
+            }
+            std::sort(nodes.begin() + static_cast<std::ptrdiff_t>(first), nodes.end(),
+                      [](const Node& a, const Node& b) { return a.name < b.name; });
+            nodes[i].first_child = first;
+            nodes[i].child_count = nodes.size() - first;
+        }
+
+        strings_.reset(new char[string_bytes > 0 ? string_bytes : 1]);
+        char* cursor = strings_.get();
+        auto store = [&cursor](std::string_view text) {
+            if (text.empty()) return std::string_view();
+            std::memcpy(cursor, text.data(), text.size());
+            std::string_view stored(cursor, text.size());
+            cursor += text.size();
+            return stored;
+        };
+
+        keys_.reserve(value_count + nodes.size());
+        values_.reserve(value_count);
+        sections_.resize(nodes.size());
+
+        std::vector<size_t> first_value(nodes.size());
+        std::vector<ValueEntry> entries;
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            const Section& section = *nodes[i].section;
+            entries.clear();
+            for (auto it = section.values_begin(); it != section.values_end(); ++it) {
+                entries.emplace_back(it->first, &it->second);
+            }
+            std::sort(entries.begin(), entries.end(),
+                      [](const ValueEntry& a, const ValueEntry& b) { return a.first < b.first; });
+
+            first_value[i] = keys_.size();
+            for (const ValueEntry& entry : entries) {
+                keys_.push_back(store(entry.first));
+                values_.push_back(*entry.second);
+            }
+            sections_[i].name_ = i == 0 ? std::string_view() : store(nodes[i].name);
+            sections_[i].value_count_ = entries.size();
+        }
+
+        // Section names follow the value keys in the same array
+        size_t names_begin = keys_.size();
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            keys_.push_back(sections_[i].name_);
+        }
+
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            FrozenSection& section = sections_[i];
+            section.keys_ = keys_.data() + first_value[i];
+            section.values_ = values_.data() + first_value[i];
+            section.section_names_ = keys_.data() + names_begin + nodes[i].first_child;
+            section.sections_ = sections_.data() + nodes[i].first_child;
+            section.section_count_ = nodes[i].child_count;
+        }
+    }
+
+    FrozenDocument(const FrozenDocument&) = delete;
+    FrozenDocument& operator=(const FrozenDocument&) = delete;
+    FrozenDocument(FrozenDocument&&) noexcept = default;
+    FrozenDocument& operator=(FrozenDocument&&) noexcept = default;
+
+    const FrozenSection& root() const { return sections_.front(); }
+
+    const Value* find(std::string_view key) const { return root().find(key); }
+    const Value& at(std::string_view key) const { return root().at(key); }
+    const FrozenSection& get_section(std::string_view name) const { return root().get_section(name); }
+};
+
+namespace detail {
+
+inline unsigned lowest_bit(std::uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+#if defined(YINI_SIMD_AVX2_DISPATCH)
+__attribute__((target("avx2"))) inline size_t find_either_avx2(const char* data, size_t pos, size_t size, char a,
+                                                               char b) {
+    const __m256i want_a = _mm256_set1_epi8(a);
+    const __m256i want_b = _mm256_set1_epi8(b);
+    for (; pos + 32 <= size; pos += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(block, want_a), _mm256_cmpeq_epi8(block, want_b));
+        std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(hits));
+        if (mask) return pos + lowest_bit(mask);
+    }
+    return pos;
+}
+
+inline bool cpu_has_avx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+#endif
+
+// Index of the first a or b in data[pos, size), or size. This is the lexer's
+// inner loop: bytes that cannot end a line or start a comment are skipped
+// a whole vector at a time.
+inline size_t find_either(const char* data, size_t pos, size_t size, char a, char b) {
+#if defined(YINI_SIMD_AVX2)
+    const __m256i want_a = _mm256_set1_epi8(a);
+    const __m256i want_b = _mm256_set1_epi8(b);
+    for (; pos + 32 <= size; pos += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(block, want_a), _mm256_cmpeq_epi8(block, want_b));
+        std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(hits));
+        if (mask) return pos + lowest_bit(mask);
+    }
+#elif defined(YINI_SIMD_SSE2)
+#if defined(YINI_SIMD_AVX2_DISPATCH)
+    if (size - pos >= 32 && cpu_has_avx2()) {
+        pos = find_either_avx2(data, pos, size, a, b);
+        if (pos < size && (data[pos] == a || data[pos] == b)) return pos;
+    }
+#endif
+    const __m128i want_a = _mm_set1_epi8(a);
+    const __m128i want_b = _mm_set1_epi8(b);
+    for (; pos + 16 <= size; pos += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(block, want_a), _mm_cmpeq_epi8(block, want_b));
+        std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(hits));
+        if (mask) return pos + lowest_bit(mask);
+    }
+#elif defined(YINI_SIMD_NEON)
+    const uint8x16_t want_a = vdupq_n_u8(static_cast<std::uint8_t>(a));
+    const uint8x16_t want_b = vdupq_n_u8(static_cast<std::uint8_t>(b));
+    for (; pos + 16 <= size; pos += 16) {
+        uint8x16_t block = vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + pos));
+        uint8x16_t hits = vorrq_u8(vceqq_u8(block, want_a), vceqq_u8(block, want_b));
+        // Narrow to four bits per byte to get a scalar mask
+        std::uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hits), 4)), 0);
+        if (mask) {
+            while ((mask & 0xf) == 0) {
+                mask >>= 4;
+                ++pos;
+            }
+            return pos;
+        }
+    }
+#else
+    // Eight bytes at a time: a byte equal to a or b becomes zero after the
+    // xor, and the zero-byte test below is exact for the whole word
+    constexpr std::uint64_t ones = 0x0101010101010101ULL;
+    constexpr std::uint64_t highs = 0x8080808080808080ULL;
+    const std::uint64_t spread_a = ones * static_cast<std::uint8_t>(a);
+    const std::uint64_t spread_b = ones * static_cast<std::uint8_t>(b);
+    for (; pos + 8 <= size; pos += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data + pos, sizeof(word));
+        std::uint64_t x = word ^ spread_a;
+        std::uint64_t y = word ^ spread_b;
+        if ((((x - ones) & ~x) | ((y - ones) & ~y)) & highs) break;
+    }
+#endif
+    for (; pos < size; ++pos) {
+        if (data[pos] == a || data[pos] == b) return pos;
+    }
+    return size;
+}
+
+} // namespace detail
+
+// A single logical line produced by the lexer
+struct Token {
+    enum class Type { Section, Entry };
+
+    Type type = Type::Entry;
+    std::string_view name;   // Section name or key
+    std::string_view value;  // Raw value text (entries only)
+    int depth = 0;           // Number of carets (sections only)
+    size_t line = 0;         // Line the token starts on
+};
+
+// Single-pass lexer over a string_view. Comments are skipped in the same
+// pass and tokens are views into the input; the internal scratch buffer is
+// only used when a block comment splits a line into two non-blank halves,
+// or when a line straddles two chunks in push mode. Views stay valid until
+// the next call to next() or push().
+class Lexer {
+private:
+    enum class State { Text, LineComment, BlockComment };
+
+    std::string_view input_;
+    size_t pos_ = 0;
+    bool final_ = true;
+    State state_ = State::Text;
+    bool slash_pending_ = false;  // Chunk ended on '/' outside a comment
+    bool star_pending_ = false;   // Chunk ended on '*' inside a block comment
+
+    size_t line_ = 0;
+    size_t token_line_ = 0;
+    bool line_open_ = false;
+
+    std::string_view first_;  // First non-blank segment of the current line
+    std::string_view gap_;    // Blank segment following first_
+    std::string scratch_;
+    bool use_scratch_ = false;
+
+    void add_segment(std::string_view segment) {
+        if (segment.empty()) return;
+        if (use_scratch_) {
+            scratch_.append(segment.data(), segment.size());
+            return;
+        }
+
+        bool blank = detail::trim(segment).empty();
+        if (first_.empty()) {
+            if (!blank) first_ = segment;
+            return;
+        }
+        if (blank && gap_.empty()) {
+            gap_ = segment;
+            return;
+        }
+
+        // Two non-blank pieces (or more than one gap): stitch them together
+        scratch_.assign(first_.data(), first_.size());
+        scratch_.append(gap_.data(), gap_.size());
+        scratch_.append(segment.data(), segment.size());
+        use_scratch_ = true;
+    }
+
+    // Moves the partial line out of a chunk that is about to be replaced
+    void detach() {
+        if (use_scratch_ || first_.empty()) return;
+        scratch_.assign(first_.data(), first_.size());
+        scratch_.append(gap_.data(), gap_.size());
+        use_scratch_ = true;
+    }
+
+    void begin_line() {
+        first_ = {};
+        gap_ = {};
+        use_scratch_ = false;
+        ++line_;
+        token_line_ = line_;
+        line_open_ = true;
+    }
+
+    std::string_view end_line() {
+        line_open_ = false;
+        return use_scratch_ ? std::string_view(scratch_) : first_;
+    }
+
+    // Reads one logical line, skipping // and /* */ comments. Returns false
+    // when the input is exhausted, or when a push-mode chunk ends mid-line.
+    bool read_line(std::string_view& out) {
+        const size_t size = input_.size();
+        if (!line_open_) {
+            if (pos_ >= size) return false;
+            begin_line();
+        }
+
+        size_t segment_start = pos_;
+        while (pos_ < size) {
+            if (state_ == State::LineComment) {
+                size_t eol = input_.find('\n', pos_);
+                if (eol == std::string_view::npos) {
+                    pos_ = size;
+                    break;
+                }
+                pos_ = eol;
+                segment_start = pos_;
+                state_ = State::Text;
+                continue;
+            }
+
+            if (state_ == State::BlockComment) {
+                // Stop on newlines to count them and on '*' to find "*/"
+                size_t stop = detail::find_either(input_.data(), pos_, size, '*', '\n');
+                if (stop == size) {
+                    // An unclosed comment runs to the end of the input
+                    pos_ = size;
+                    break;
+                }
+                if (input_[stop] == '\n') {
+                    ++line_;
+                    pos_ = stop + 1;
+                } else if (stop + 1 < size && input_[stop + 1] == '/') {
+                    pos_ = stop + 2;
+                    segment_start = pos_;
+                    state_ = State::Text;
+                } else if (stop + 1 == size) {
+                    // "*" at the end of a chunk may close with the next one
+                    star_pending_ = !final_;
+                    pos_ = size;
+                    break;
+                } else {
+                    pos_ = stop + 1;
+                }
+                continue;
+            }
+
+            pos_ = detail::find_either(input_.data(), pos_, size, '\n', '/');
+            if (pos_ == size) break;
+            char c = input_[pos_];
+            if (c == '\n') {
+                add_segment(input_.substr(segment_start, pos_ - segment_start));
+                ++pos_;
+                out = end_line();
+                return true;
+            }
+            if (c == '/') {
+                if (pos_ + 1 == size && !final_) {
+                    add_segment(input_.substr(segment_start, pos_ - segment_start));
+                    slash_pending_ = true;
+                    pos_ = size;
+                    detach();
+                    return false;
+                }
+                char next = pos_ + 1 < size ? input_[pos_ + 1] : '\0';
+                if (next == '/' || next == '*') {
+                    add_segment(input_.substr(segment_start, pos_ - segment_start));
+                    state_ = next == '/' ? State::LineComment : State::BlockComment;
+                    pos_ += 2;
+                    continue;
+                }
+            }
+            ++pos_;
+        }
+
+        if (state_ == State::Text) {
+            add_segment(input_.substr(segment_start, pos_ - segment_start));
+        }
+        if (!final_) {
+            detach();
+            return false;
+        }
+        out = end_line();
+        return true;
+    }
+
+    void tokenize(std::string_view line, Token& token) {
+        token.line = token_line_;
+
+        int carets = 0;
+        while (static_cast<size_t>(carets) < line.size() && line[carets] == '^') ++carets;
+
+        if (carets > 0) {
+            token.type = Token::Type::Section;
+            token.depth = carets;
+            token.name = detail::trim(line.substr(carets));
+            token.value = {};
+            return;
+        }
+
+        size_t equals_pos = line.find('=');
+        if (equals_pos == std::string_view::npos) {
+            throw ParseError("Invalid line format at line " + std::to_string(token_line_) + ": " + std::string(line));
+        }
+
+        token.type = Token::Type::Entry;
+        token.depth = 0;
+        token.name = detail::trim(line.substr(0, equals_pos));
+        token.value = detail::trim(line.substr(equals_pos + 1));
+
+        if (token.name.empty()) {
+            throw ParseError("Empty key at line " + std::to_string(token_line_) + ": " + std::string(line));
+        }
+    }
+
+public:
+    // Lex a complete buffer
+    explicit Lexer(std::string_view input) : input_(input) {}
+
+    // Push mode: supply the input chunk by chunk through push()
+    Lexer() : final_(false) {}
+
+    // Hand the lexer its next chunk; only the partial line carried over from
+    // the previous chunk is kept in memory
+    void push(std::string_view chunk, bool final = false) {
+        input_ = chunk;
+        pos_ = 0;
+        final_ = final;
+
+        if (chunk.empty() && !final) return;
+
+        if (slash_pending_) {
+            slash_pending_ = false;
+            char next = chunk.empty() ? '\0' : chunk[0];
+            if (next == '/' || next == '*') {
+                state_ = next == '/' ? State::LineComment : State::BlockComment;
+                pos_ = 1;
+            } else {
+                add_segment(std::string_view("/"));
+            }
+        }
+        if (star_pending_) {
+            star_pending_ = false;
+            if (!chunk.empty() && chunk[0] == '/') {
+                state_ = State::Text;
+                pos_ = 1;
+            }
+        }
+    }
+
+    // Advance to the next section header or key/value pair
+    bool next(Token& token) {
+        std::string_view line;
+        while (read_line(line)) {
+            line = detail::trim(line);
+            if (line.empty()) continue;
+            tokenize(line, token);
+            return true;
+        }
+        return false;
+    }
+
+    // Line on which the current token starts
+    size_t line() const { return token_line_; }
+};
+
+// Calls fn(kind, raw) for every element of a raw array token such as
+// "[1, 'two', [3, 4]]". As with Visitor::on_value, raw is the unquoted text
+// for strings and the token itself otherwise; nested arrays are passed
+// through as array tokens for the caller to descend into.
+template <typename Fn>
+void for_each_element(std::string_view array, Fn&& fn) {
+    array = detail::trim(array);
+    if (array.size() < 2 || array.front() != '[' || array.back() != ']') return;
+    detail::for_each_item(array.substr(1, array.size() - 2), [&](std::string_view item) {
+        detail::Scalar scalar = detail::classify_scalar(item);
+        fn(scalar.kind, scalar.text);
+    });
+}
+
+inline Value make_value(TokenKind kind, std::string_view raw);
+
+namespace detail {
+
+// Builds an array from its body in one pass. Items are collected packed
+// while they are all integers or all doubles; the first item of another
+// kind boxes what was collected and the rest are boxed as they are read.
+// Empty arrays stay plain, so neither packed kind is picked arbitrarily.
+inline Value build_array(std::string_view body, size_t count) {
+    enum class Mode { Empty, Ints, Doubles, Boxed };
+    Mode mode = Mode::Empty;
+    std::vector<std::int64_t> ints;
+    std::vector<double> doubles;
+    std::vector<Value> boxed;
+
+    for_each_item(body, [&](std::string_view item) {
+        Scalar scalar = classify_scalar(item);
+        if (mode == Mode::Empty) {
+            if (scalar.kind == TokenKind::Int) {
+                mode = Mode::Ints;
+                ints.reserve(count);
+            } else if (scalar.kind == TokenKind::Double) {
+                mode = Mode::Doubles;
+                doubles.reserve(count);
+            } else {
+                mode = Mode::Boxed;
+                boxed.reserve(count);
+            }
+        } else if ((mode == Mode::Ints && scalar.kind != TokenKind::Int) ||
+                   (mode == Mode::Doubles && scalar.kind != TokenKind::Double)) {
+            boxed.reserve(count);
+            for (std::int64_t number : ints) boxed.emplace_back(number);
+            for (double real : doubles) boxed.emplace_back(real);
+            ints = std::vector<std::int64_t>();
+            doubles = std::vector<double>();
+            mode = Mode::Boxed;
+        }
+
+        switch (mode) {
+            case Mode::Ints: ints.push_back(scalar.int_value); break;
+            case Mode::Doubles: doubles.push_back(scalar.double_value); break;
+            default: boxed.push_back(make_value(scalar.kind, scalar.text)); break;
+        }
+    });
+
+    if (mode == Mode::Ints) return Value(std::move(ints));
+    if (mode == Mode::Doubles) return Value(std::move(doubles));
+    return Value(std::move(boxed));
+}
+
+// Plain array from a decoder, packed when the elements allow it
+inline Value pack_or_box(std::vector<Value>&& items) {
+    if (items.empty()) return Value(std::move(items));
+    if (items.front().is_int() || items.front().is_double()) {
+        bool ints = items.front().is_int();
+        bool uniform = std::all_of(items.begin(), items.end(), [ints](const Value& item) {
+            return ints ? item.is_int() : item.is_double();
+        });
+        if (uniform && ints) {
+            std::vector<std::int64_t> numbers;
+            numbers.reserve(items.size());
+            for (const Value& item : items) numbers.push_back(*item.get_if<std::int64_t>());
+            return Value(std::move(numbers));
+        }
+        if (uniform) {
+            std::vector<double> numbers;
+            numbers.reserve(items.size());
+            for (const Value& item : items) numbers.push_back(*item.get_if<double>());
+            return Value(std::move(numbers));
+        }
+    }
+    return Value(std::move(items));
+}
+
+} // namespace detail
+
+// Builds a Value from a classified token
+inline Value make_value(TokenKind kind, std::string_view raw) {
+    switch (kind) {
+        case TokenKind::Bool: {
+            bool result = false;
+            detail::parse_bool(raw, result);
+            return Value(result);
+        }
+        case TokenKind::Int: {
+            std::int64_t result = 0;
+            detail::parse_int(raw, result);
+            return Value(result);
+        }
+        case TokenKind::Double: {
+            double result = 0.0;
+            detail::parse_double(raw, result);
+            return Value(result);
+        }
+        case TokenKind::Array: {
+            std::string_view body = raw.size() >= 2 ? raw.substr(1, raw.size() - 2) : std::string_view();
+            return detail::build_array(body, detail::count_items(body));
+        }
+        case TokenKind::String:
+            break;
+    }
+    return Value(std::string(raw));
+}
+
+// Base class for SAX visitors. Events are dispatched statically, so derive
+// from it and hide whichever handlers you need; the rest are no-ops.
+//
+//   on_section_enter(path, depth) - a header was read; path holds the names
+//                                   from the top level down to it
+//   on_value(key, kind, raw)      - a key/value pair in the innermost section
+//   on_section_exit(path, depth)  - the section at the end of path is closed
+//
+// Views are only valid for the duration of the call.
+struct Visitor {
+    void on_section_enter(Span<const std::string_view> /*path*/, int /*depth*/) {}
+    void on_value(std::string_view /*key*/, TokenKind /*kind*/, std::string_view /*raw*/) {}
+    void on_section_exit(Span<const std::string_view> /*path*/, int /*depth*/) {}
+};
+
+// Drives a visitor from the lexer, either over a complete buffer with
+// parse() or incrementally with feed()/finish(). No tree is built; the
+// only memory kept is the lexer's partial line and the current path.
+template <typename V>
+class EventReader {
+private:
+    V& visitor_;
+    Lexer lexer_;
+    std::vector<std::string> names_;       // Owned copies of the open path
+    std::vector<std::string_view> path_;   // Views over names_
+    bool streaming_ = false;
+
+    Span<const std::string_view> path() const {
+        return Span<const std::string_view>(path_.data(), path_.size());
+    }
+
+    void enter(std::string_view name) {
+        size_t depth = path_.size();
+        if (names_.size() <= depth) names_.emplace_back();
+        names_[depth].assign(name.data(), name.size());
+
+        // names_ may have moved its strings, so refresh every view
+        path_.resize(depth + 1);
+        for (size_t i = 0; i <= depth; ++i) path_[i] = names_[i];
+        visitor_.on_section_enter(path(), static_cast<int>(depth + 1));
+    }
+
+    void exit() {
+        visitor_.on_section_exit(path(), static_cast<int>(path_.size()));
+        path_.pop_back();
+    }
+
+    void close_all() {
+        while (!path_.empty()) exit();
+    }
+
+    void dispatch(const Token& token) {
+        if (token.type == Token::Type::Section) {
+            // Adjust the open path to match nesting level
+            size_t depth = static_cast<size_t>(token.depth);
+            while (path_.size() >= depth) exit();
+            while (path_.size() + 1 < depth) enter(std::string_view());
+            enter(token.name);
+        } else {
+            detail::Scalar scalar = detail::classify_scalar(token.value);
+            visitor_.on_value(token.name, scalar.kind, scalar.text);
+        }
+    }
+
+    void drain() {
+        Token token;
+        while (true) {
+            try {
+                if (!lexer_.next(token)) break;
+                dispatch(token);
+            } catch (const std::exception& e) {
+                streaming_ = false;
+                path_.clear();
+                throw ParseError("Error at line " + std::to_string(lexer_.line()) + ": " + e.what());
+            }
+        }
+    }
+
+public:
+    explicit EventReader(V& visitor) : visitor_(visitor) {}
+
+    // Parse a complete buffer
+    void parse(std::string_view content) {
+        streaming_ = false;
+        path_.clear();
+        lexer_ = Lexer(content);
+        drain();
+        close_all();
+    }
+
+    // Push the next chunk of a streamed input
+    void feed(const char* data, size_t size) {
+        if (!streaming_) {
+            path_.clear();
+            lexer_ = Lexer();
+            streaming_ = true;
+        }
+        lexer_.push(std::string_view(data, size));
+        drain();
+    }
+
+    // End a streamed input, closing every open section
+    void finish() {
+        if (!streaming_) return;
+        lexer_.push(std::string_view(), true);
+        drain();
+        streaming_ = false;
+        close_all();
+    }
+
+    bool streaming() const { return streaming_; }
+};
+
+// Runs a visitor over a complete buffer
+template <typename V>
+void sax_parse(std::string_view content, V& visitor) {
+    EventReader<V> reader(visitor);
+    reader.parse(content);
+}
+
+namespace detail {
+
+// Visitor that builds a Section tree
+class TreeBuilder : public Visitor {
+private:
+    std::vector<Section*> section_stack_;
+
+public:
+    explicit TreeBuilder(Section& root) : section_stack_{&root} {}
+
+    // Point the bottom of the stack at a root that was moved. Open subsections
+    // are heap-allocated and keep their addresses when their root moves.
+    void rebase(Section& root) { section_stack_.front() = &root; }
+
+    void on_section_enter(Span<const std::string_view> path, int /*depth*/) {
+        section_stack_.push_back(&section_stack_.back()->section(path[path.size() - 1]));
+    }
+
+    void on_value(std::string_view key, TokenKind kind, std::string_view raw) {
+        (*section_stack_.back())[key] = make_value(kind, raw);
+    }
+
+    // Store a value that was already built
+    void insert(std::string_view key, Value&& value) {
+        (*section_stack_.back())[key] = std::move(value);
+    }
+
+    void on_section_exit(Span<const std::string_view> /*path*/, int /*depth*/) {
+        section_stack_.pop_back();
+    }
+};
+
+} // namespace detail
+
+// Measurements from an instrumented parse; pass one to the Parser overloads
+// that take a ParseStats&. The plain overloads are not instrumented and do
+// no extra work.
+struct ParseStats {
+    size_t bytes = 0;
+    size_t lines = 0;
+    size_t sections = 0;
+    size_t keys = 0;
+    size_t values_by_kind[5] = {};  // Indexed by TokenKind
+    size_t array_elements = 0;
+    size_t largest_array = 0;
+    std::string largest_array_key;
+    int max_depth = 0;
+    std::uint64_t allocations = 0;  // Only filled when allocation_counter is set
+
+    // Lexing covers comment stripping and tokenizing, which share one pass
+    std::chrono::nanoseconds total{0};
+    std::chrono::nanoseconds lexing{0};
+    std::chrono::nanoseconds value_parsing{0};
+    std::chrono::nanoseconds tree_building{0};
+
+    // Optional: returns the process-wide allocation count (for example from
+    // a counting operator new); sampled before and after the parse
+    std::function<std::uint64_t()> allocation_counter;
+
+    // Optional: called with begin = true/false around the whole parse
+    // ("parse") and around each top-level section (its name)
+    std::function<void(std::string_view span, bool begin)> trace;
+
+    size_t values(TokenKind kind) const { return values_by_kind[static_cast<size_t>(kind)]; }
+};
+
+namespace detail {
+
+// Tree builder that records ParseStats as events pass through
+class StatsBuilder : public Visitor {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    TreeBuilder builder_;
+    ParseStats& stats_;
+
+public:
+    StatsBuilder(Section& root, ParseStats& stats) : builder_(root), stats_(stats) {}
+
+    void on_section_enter(Span<const std::string_view> path, int depth) {
+        ++stats_.sections;
+        stats_.max_depth = std::max(stats_.max_depth, static_cast<int>(path.size()));
+        if (path.size() == 1 && stats_.trace) stats_.trace(path[0], true);
+
+        Clock::time_point start = Clock::now();
+        builder_.on_section_enter(path, depth);
+        stats_.tree_building += Clock::now() - start;
+    }
+
+    void on_value(std::string_view key, TokenKind kind, std::string_view raw) {
+        ++stats_.keys;
+        ++stats_.values_by_kind[static_cast<size_t>(kind)];
+
+        Clock::time_point start = Clock::now();
+        Value value = make_value(kind, raw);
+        Clock::time_point built = Clock::now();
+        builder_.insert(key, std::move(value));
+        Clock::time_point stored = Clock::now();
+        stats_.value_parsing += built - start;
+        stats_.tree_building += stored - built;
+
+        if (kind == TokenKind::Array) {
+            size_t elements = 0;
+            for_each_element(raw, [&elements](TokenKind, std::string_view) { ++elements; });
+            stats_.array_elements += elements;
+            if (elements > stats_.largest_array) {
+                stats_.largest_array = elements;
+                stats_.largest_array_key.assign(key.data(), key.size());
+            }
+        }
+    }
+
+    void on_section_exit(Span<const std::string_view> path, int depth) {
+        builder_.on_section_exit(path, depth);
+        if (path.size() == 1 && stats_.trace) stats_.trace(path[0], false);
+    }
+};
+
+} // namespace detail
+
+namespace detail {
+
+// Whole-file input: memory-mapped when the file is a regular, non-empty
+// file, otherwise read in fixed-size chunks (pipes, character devices and
+// filesystems that refuse mmap).
+class FileSource {
+public:
+    static constexpr size_t chunk_size = 64 * 1024;
+
+private:
+    std::string filename_;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    size_t size_hint_ = 0;
+    bool mapped_ = false;
+
+#if defined(_WIN32)
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+
+    void open() {
+        file_ = CreateFileA(filename_.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            throw FileError("Cannot open file: " + filename_);
+        }
+
+        LARGE_INTEGER size{};
+        if (GetFileType(file_) != FILE_TYPE_DISK || !GetFileSizeEx(file_, &size) || size.QuadPart <= 0) {
+            return;
+        }
+        size_hint_ = static_cast<size_t>(size.QuadPart);
+
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping_) return;
+
+        const void* view = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+        if (!view) {
+            CloseHandle(mapping_);
+            mapping_ = nullptr;
+            return;
+        }
+        data_ = static_cast<const char*>(view);
+        size_ = size_hint_;
+        mapped_ = true;
+    }
+
+    void close() {
+        if (mapped_) {
+            UnmapViewOfFile(data_);
+            CloseHandle(mapping_);
+        }
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+    }
+
+#else
+    int fd_ = -1;
+
+    void open() {
+        fd_ = ::open(filename_.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) {
+            throw FileError("Cannot open file: " + filename_);
+        }
+
+        struct stat info {};
+        if (::fstat(fd_, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size <= 0) {
+            return;
+        }
+        size_hint_ = static_cast<size_t>(info.st_size);
+
+        void* view = ::mmap(nullptr, size_hint_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (view == MAP_FAILED) return;
+
+        ::madvise(view, size_hint_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(view);
+        size_ = size_hint_;
+        mapped_ = true;
+    }
+
+    void close() {
+        if (mapped_) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+#endif
+
+public:
+    explicit FileSource(const std::string& filename) : filename_(filename) { open(); }
+    ~FileSource() { close(); }
+
+    FileSource(const FileSource&) = delete;
+    FileSource& operator=(const FileSource&) = delete;
+
+    bool mapped() const { return mapped_; }
+
+    // Contents of a mapped file
+    std::string_view view() const { return std::string_view(data_, size_); }
+
+    // Reads the next chunk of an unmapped file; returns 0 at the end
+    size_t read(char* buffer, size_t capacity) {
+#if defined(_WIN32)
+        DWORD got = 0;
+        if (!ReadFile(file_, buffer, static_cast<DWORD>(capacity), &got, nullptr)) {
+            if (GetLastError() == ERROR_BROKEN_PIPE) return 0;
+            throw FileError("Cannot read file: " + filename_);
+        }
+        return got;
+#else
+        while (true) {
+            ssize_t got = ::read(fd_, buffer, capacity);
+            if (got >= 0) return static_cast<size_t>(got);
+            if (errno != EINTR) {
+                throw FileError("Cannot read file: " + filename_);
+            }
+        }
+#endif
+    }
+
+    // Whole contents as a string, for consumers that cannot stream
+    std::string read_all() {
+        if (mapped_) return std::string(view());
+
+        std::string content;
+        content.reserve(size_hint_);
+        char chunk[chunk_size];
+        while (size_t got = read(chunk, sizeof(chunk))) {
+            content.append(chunk, got);
+        }
+        return content;
+    }
+};
+
+} // namespace detail
+
+namespace detail {
+
+// Output file written in large blocks straight to the descriptor/handle
+class FileSink {
+private:
+    std::string filename_;
+#if defined(_WIN32)
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+#else
+    int fd_ = -1;
+#endif
+
+public:
+    // With create_new, an existing file is left alone and the sink stays
+    // closed; check is_open()
+    explicit FileSink(const std::string& filename, bool create_new = false) : filename_(filename) {
+#if defined(_WIN32)
+        file_ = CreateFileA(filename.c_str(), GENERIC_WRITE, 0, nullptr, create_new ? CREATE_NEW : CREATE_ALWAYS,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            if (create_new && GetLastError() == ERROR_FILE_EXISTS) return;
+            throw FileError("Cannot write to file: " + filename);
+        }
+#else
+        int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (create_new ? O_EXCL : O_TRUNC);
+        fd_ = ::open(filename.c_str(), flags, 0644);
+        if (fd_ < 0) {
+            if (create_new && errno == EEXIST) return;
+            throw FileError("Cannot write to file: " + filename);
+        }
+#endif
+    }
+
+    ~FileSink() {
+#if defined(_WIN32)
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+        if (fd_ >= 0) ::close(fd_);
+#endif
+    }
+
+    bool is_open() const {
+#if defined(_WIN32)
+        return file_ != INVALID_HANDLE_VALUE;
+#else
+        return fd_ >= 0;
+#endif
+    }
+
+    // Close now and report failure, which the destructor cannot
+    void close() {
+#if defined(_WIN32)
+        bool closed = file_ == INVALID_HANDLE_VALUE || CloseHandle(file_);
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        bool closed = fd_ < 0 || ::close(fd_) == 0;
+        fd_ = -1;
+#endif
+        if (!closed) throw FileError("Cannot write to file: " + filename_);
+    }
+
+    FileSink(const FileSink&) = delete;
+    FileSink& operator=(const FileSink&) = delete;
+
+    void write(const char* data, size_t size) {
+        while (size > 0) {
+#if defined(_WIN32)
+            DWORD written = 0;
+            DWORD request = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+            if (!WriteFile(file_, data, request, &written, nullptr)) {
+                throw FileError("Cannot write to file: " + filename_);
+            }
+#else
+            ssize_t written = ::write(fd_, data, size);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                throw FileError("Cannot write to file: " + filename_);
+            }
+#endif
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+};
+
+// Move a finished temporary file over target, replacing it in one step
+inline void replace_file(const std::string& temporary, const std::string& target) {
+#if defined(_WIN32)
+    bool moved = MoveFileExA(temporary.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    bool moved = std::rename(temporary.c_str(), target.c_str()) == 0;
+#endif
+    if (!moved) {
+        std::remove(temporary.c_str());
+        throw FileError("Cannot write to file: " + target);
+    }
+}
+
+// Name for a temporary next to target, unique to this process and call.
+// Create it exclusively and pick another name if it already exists.
+inline std::string temporary_name(const std::string& target) {
+    static std::atomic<std::uint64_t> counter{0};
+#if defined(_WIN32)
+    std::string process = std::to_string(GetCurrentProcessId());
+#else
+    std::string process = std::to_string(::getpid());
+#endif
+    return target + "." + process + "." + std::to_string(counter.fetch_add(1)) + ".tmp";
+}
+
+// Output that replaces target only once it is complete. Data goes to a
+// temporary next to target, created exclusively under temporary_name(),
+// so concurrent writers and existing files are never clobbered; commit()
+// moves it over target. An uncommitted temporary is removed on
+// destruction.
+class FileReplacement {
+private:
+    std::string target_;
+    std::string temporary_;
+    std::unique_ptr<FileSink> sink_;
+
+public:
+    explicit FileReplacement(const std::string& target) : target_(target) {
+        for (int attempt = 0; attempt < 100; ++attempt) {
+            temporary_ = temporary_name(target);
+            sink_ = std::make_unique<FileSink>(temporary_, true);
+            if (sink_->is_open()) return;
+        }
+        sink_.reset();
+        throw FileError("Cannot create a temporary file for: " + target);
+    }
+
+    ~FileReplacement() {
+        if (sink_) {
+            sink_.reset();
+            std::remove(temporary_.c_str());
+        }
+    }
+
+    FileReplacement(const FileReplacement&) = delete;
+    FileReplacement& operator=(const FileReplacement&) = delete;
+
+    void write(const char* data, size_t size) { sink_->write(data, size); }
+
+    void commit() {
+        sink_->close();
+        sink_.reset();
+        replace_file(temporary_, target_);
+    }
+};
+
+} // namespace detail
+
+// Serialises sections into a reusable char buffer. Numbers are formatted
+// with std::to_chars (shortest round-trip for doubles). With a sink, the
+// buffer is handed over whenever it passes flush_threshold bytes and on
+// flush(); without one it simply accumulates.
+class Writer {
+public:
+    using Sink = std::function<void(const char*, size_t)>;
+
+    static constexpr size_t default_flush_threshold = 64 * 1024;
+
+private:
+    std::string buffer_;
+    Sink sink_;
+    size_t flush_threshold_ = default_flush_threshold;
+    bool top_level_written_ = false;  // Streaming: a top-level header was emitted
+
+    void indent(int level) {
+        buffer_.append(static_cast<size_t>(level) * 4, ' ');
+    }
+
+    void maybe_flush() {
+        if (sink_ && buffer_.size() >= flush_threshold_) flush();
+    }
+
+    void write_number(std::int64_t value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer_.append(digits, result.ptr);
+    }
+
+    void write_number(double value) {
+        // The format has no spelling for inf or nan; written out they would
+        // read back as strings
+        if (!std::isfinite(value)) throw std::runtime_error("Cannot write non-finite number");
+
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        std::string_view text(digits, static_cast<size_t>(result.ptr - digits));
+        buffer_.append(text.data(), text.size());
+
+        // Keep a marker so the value reads back as a double
+        if (text.find_first_of(".e") == std::string_view::npos) buffer_.append(".0");
+    }
+
+    void write_value(const Value& value) {
+        if (const std::string* text = value.get_if<std::string>()) {
+            buffer_.push_back('\'');
+            buffer_.append(*text);
+            buffer_.push_back('\'');
+        } else if (const std::int64_t* number = value.get_if<std::int64_t>()) {
+            write_number(*number);
+        } else if (const double* real = value.get_if<double>()) {
+            write_number(*real);
+        } else if (const bool* flag = value.get_if<bool>()) {
+            buffer_.append(*flag ? "true" : "false");
+        } else if (const PackedArray* packed = value.get_if<PackedArray>()) {
+            buffer_.push_back('[');
+            for (size_t i = 0; i < packed->size(); ++i) {
+                if (i > 0) buffer_.append(", ");
+                if (packed->kind() == TokenKind::Int) {
+                    write_number(packed->ints()[i]);
+                } else {
+                    write_number(packed->doubles()[i]);
+                }
+            }
+            buffer_.push_back(']');
+        } else {
+            buffer_.push_back('[');
+            const auto& array = value.array_ref();
+            for (size_t i = 0; i < array.size(); ++i) {
+                if (i > 0) buffer_.append(", ");
+                write_value(array[i]);
+            }
+            buffer_.push_back(']');
+        }
+    }
+
+    void write_item(std::string_view text) {
+        buffer_.push_back('\'');
+        buffer_.append(text.data(), text.size());
+        buffer_.push_back('\'');
+    }
+
+    void write_item(const std::string& text) { write_item(std::string_view(text)); }
+    void write_item(const char* text) { write_item(std::string_view(text)); }
+    void write_item(bool flag) { buffer_.append(flag ? "true" : "false"); }
+    void write_item(const Value& value) { write_value(value); }
+
+    template <typename T, std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, int> = 0>
+    void write_item(T number) {
+        if constexpr (std::is_floating_point_v<T>) {
+            write_number(static_cast<double>(number));
+        } else {
+            write_number(static_cast<std::int64_t>(number));
+        }
+    }
+
+    template <typename T>
+    void write_item(const std::vector<T>& items) {
+        buffer_.push_back('[');
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (i > 0) buffer_.append(", ");
+            write_item(items[i]);
+        }
+        buffer_.push_back(']');
+    }
+
+    void write_section(const Section& section, std::string_view name, bool is_root, int indent_level) {
+        // Write section header if not root
+        if (!is_root) {
+            indent(indent_level);
+            buffer_.append(static_cast<size_t>(indent_level) + 1, '^');
+            buffer_.push_back(' ');
+            buffer_.append(name.data(), name.size());
+            buffer_.push_back('\n');
+        }
+
+        // Write values
+        int value_indent = indent_level + (is_root ? 0 : 1);
+        for (auto it = section.values_begin(); it != section.values_end(); ++it) {
+            indent(value_indent);
+            buffer_.append(it->first);
+            buffer_.append(" = ");
+            write_value(it->second);
+            buffer_.push_back('\n');
+            maybe_flush();
+        }
+
+        // Write subsections
+        for (auto it = section.sections_begin(); it != section.sections_end(); ++it) {
+            if (!is_root || it != section.sections_begin()) {
+                buffer_.push_back('\n');
+            }
+            write_section(*it->second, it->first, false, value_indent);
+        }
+    }
+
+public:
+    Writer() = default;
+
+    explicit Writer(Sink sink, size_t flush_threshold = default_flush_threshold)
+        : sink_(std::move(sink)), flush_threshold_(flush_threshold) {}
+
+    // Append a section tree
+    void write(const Section& root) {
+        write_section(root, std::string_view(), true, 0);
+        maybe_flush();
+    }
+
+    // Streaming output built without a Section tree. depth is the caret
+    // count of the header (1 for a top-level section); entries take the
+    // depth of the section they belong to (0 for the root). Emitting root
+    // values, then each section's values before its subsections, gives the
+    // same layout as write().
+    void write_header(std::string_view name, int depth) {
+        if (depth > 1 || top_level_written_) buffer_.push_back('\n');
+        if (depth == 1) top_level_written_ = true;
+        indent(depth - 1);
+        buffer_.append(static_cast<size_t>(depth), '^');
+        buffer_.push_back(' ');
+        buffer_.append(name.data(), name.size());
+        buffer_.push_back('\n');
+    }
+
+    // Accepts strings, bools, arithmetic types, Value and std::vector of those
+    template <typename T>
+    void write_entry(std::string_view key, const T& value, int depth) {
+        indent(depth);
+        buffer_.append(key.data(), key.size());
+        buffer_.append(" = ");
+        write_item(value);
+        buffer_.push_back('\n');
+        maybe_flush();
+    }
+
+    // Hand buffered output to the sink
+    void flush() {
+        if (!sink_ || buffer_.empty()) return;
+        sink_(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+
+    // Buffered output not yet flushed
+    std::string_view view() const { return buffer_; }
+
+    // Move the buffered output out; the writer can be reused afterwards
+    std::string take() {
+        std::string result = std::move(buffer_);
+        buffer_.clear();
+        top_level_written_ = false;
+        return result;
+    }
+
+    // Drop buffered output, keeping the allocation for reuse
+    void clear() {
+        buffer_.clear();
+        top_level_written_ = false;
+    }
+};
+
+namespace detail {
+
+// Modification time and size, used to skip re-reading unchanged files
+struct FileStamp {
+    std::int64_t mtime_seconds = 0;
+    std::int64_t mtime_nanoseconds = 0;
+    std::uint64_t size = 0;
+
+    bool operator==(const FileStamp& other) const {
+        return mtime_seconds == other.mtime_seconds && mtime_nanoseconds == other.mtime_nanoseconds &&
+               size == other.size;
+    }
+};
+
+inline bool file_stamp(const std::string& filename, FileStamp& stamp) {
+#if defined(_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA info{};
+    if (!GetFileAttributesExA(filename.c_str(), GetFileExInfoStandard, &info)) return false;
+    std::uint64_t ticks = (static_cast<std::uint64_t>(info.ftLastWriteTime.dwHighDateTime) << 32) |
+                          info.ftLastWriteTime.dwLowDateTime;
+    stamp.mtime_seconds = static_cast<std::int64_t>(ticks / 10000000);
+    stamp.mtime_nanoseconds = static_cast<std::int64_t>(ticks % 10000000) * 100;
+    stamp.size = (static_cast<std::uint64_t>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+#else
+    struct stat info {};
+    if (::stat(filename.c_str(), &info) != 0) return false;
+    stamp.mtime_seconds = static_cast<std::int64_t>(info.st_mtime);
+#if defined(__APPLE__)
+    stamp.mtime_nanoseconds = static_cast<std::int64_t>(info.st_mtimespec.tv_nsec);
+#else
+    stamp.mtime_nanoseconds = static_cast<std::int64_t>(info.st_mtim.tv_nsec);
+#endif
+    stamp.size = static_cast<std::uint64_t>(info.st_size);
+#endif
+    return true;
+}
+
+// On-disk layout of a .yinib snapshot. Every record uses fixed-width fields
+// and refers to other records by index and to strings by offset, so the
+// image is position independent; it is written in host byte order and
+// rejected on hosts with a different one.
+namespace binary {
+
+constexpr char magic[8] = {'Y', 'I', 'N', 'I', 'B', '\0', '\r', '\n'};
+constexpr std::uint32_t version = 2;
+constexpr std::uint32_t byte_order = 0x01020304;
+
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t source_hash;    // Hash of the text the snapshot was built from, 0 if unknown
+    std::uint64_t source_size;    // Stamp of that text file, checked before its hash
+    std::int64_t source_mtime_seconds;
+    std::int64_t source_mtime_nanoseconds;
+    std::uint64_t payload_hash;   // Hash of everything after the header
+    std::uint64_t payload_size;
+    std::uint32_t section_count;
+    std::uint32_t value_count;
+    std::uint64_t string_bytes;
+};
+
+// Sections are stored breadth first, so the children of a section are
+// consecutive; record 0 is the root
+struct SectionRecord {
+    std::uint32_t name_offset;
+    std::uint32_t name_size;
+    std::uint32_t first_value;
+    std::uint32_t value_count;
+    std::uint32_t first_child;
+    std::uint32_t child_count;
+};
+
+// Keyed values come first, section by section; array elements follow as
+// unkeyed records, each array's elements consecutive
+struct ValueRecord {
+    std::uint32_t key_offset;
+    std::uint32_t key_size;
+    std::uint8_t kind;
+    std::uint8_t reserved[7];
+    std::uint64_t payload;  // Integer or double bits, bool, or (offset, size) / (first, count)
+};
+
+static_assert(sizeof(Header) == 80, "unexpected snapshot header layout");
+static_assert(sizeof(SectionRecord) == 24, "unexpected section record layout");
+static_assert(sizeof(ValueRecord) == 24, "unexpected value record layout");
+
+inline std::uint64_t pack(std::uint32_t low, std::uint32_t high) {
+    return static_cast<std::uint64_t>(low) | (static_cast<std::uint64_t>(high) << 32);
+}
+
+inline std::uint32_t narrow(size_t value) {
+    if (value > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::length_error("Document too large for a binary snapshot");
+    }
+    return static_cast<std::uint32_t>(value);
+}
+
+// Flattens a Section tree into the snapshot layout
+class Encoder {
+private:
+    std::vector<SectionRecord> sections_;
+    std::vector<ValueRecord> values_;
+    std::string strings_;
+
+    std::uint64_t add_string(std::string_view text) {
+        std::uint32_t offset = narrow(strings_.size());
+        strings_.append(text.data(), text.size());
+        return pack(offset, narrow(text.size()));
+    }
+
+    ValueRecord encode(std::string_view key, const Value& value, std::vector<const Value*>& arrays) {
+        ValueRecord record{};
+        std::uint64_t key_ref = add_string(key);
+        record.key_offset = static_cast<std::uint32_t>(key_ref);
+        record.key_size = static_cast<std::uint32_t>(key_ref >> 32);
+
+        if (const std::string* text = value.get_if<std::string>()) {
+            record.kind = static_cast<std::uint8_t>(TokenKind::String);
+            record.payload = add_string(*text);
+        } else if (const std::int64_t* number = value.get_if<std::int64_t>()) {
+            record.kind = static_cast<std::uint8_t>(TokenKind::Int);
+            std::memcpy(&record.payload, number, sizeof(*number));
+        } else if (const double* real = value.get_if<double>()) {
+            record.kind = static_cast<std::uint8_t>(TokenKind::Double);
+            std::memcpy(&record.payload, real, sizeof(*real));
+        } else if (const bool* flag = value.get_if<bool>()) {
+            record.kind = static_cast<std::uint8_t>(TokenKind::Bool);
+            record.payload = *flag ? 1 : 0;
+        } else {
+            // Element positions are patched once the array is laid out
+            record.kind = static_cast<std::uint8_t>(TokenKind::Array);
+            record.payload = arrays.size();
+            arrays.push_back(&value);
+        }
+        return record;
+    }
+
+public:
+    std::string encode(const Section& root, std::uint64_t source_hash, const FileStamp& source_stamp = {}) {
+        sections_.clear();
+        values_.clear();
+        strings_.clear();
+
+        // Breadth-first over sections; keyed values in section order
+        std::vector<const Section*> queue{&root};
+        sections_.push_back(SectionRecord{});
+        std::vector<const Value*> arrays;
+        std::vector<size_t> array_owner;
+
+        for (size_t i = 0; i < queue.size(); ++i) {
+            const Section& section = *queue[i];
+            SectionRecord& record = sections_[i];
+            record.first_value = narrow(values_.size());
+            for (auto it = section.values_begin(); it != section.values_end(); ++it) {
+                size_t before = arrays.size();
+                values_.push_back(encode(it->first, it->second, arrays));
+                if (arrays.size() != before) array_owner.push_back(values_.size() - 1);
+            }
+            record.value_count = narrow(values_.size() - record.first_value);
+
+            record.first_child = narrow(queue.size());
+            for (auto it = section.sections_begin(); it != section.sections_end(); ++it) {
+                SectionRecord child{};
+                std::uint64_t name_ref = add_string(it->first);
+                child.name_offset = static_cast<std::uint32_t>(name_ref);
+                child.name_size = static_cast<std::uint32_t>(name_ref >> 32);
+                sections_.push_back(child);
+                queue.push_back(it->second.get());
+            }
+            sections_[i].child_count = narrow(queue.size() - sections_[i].first_child);
+        }
+
+        // Lay out array elements; nested arrays append to the work list
+        for (size_t i = 0; i < arrays.size(); ++i) {
+            std::uint32_t first = narrow(values_.size());
+            size_t count = 0;
+            if (const PackedArray* packed = arrays[i]->get_if<PackedArray>()) {
+                count = packed->size();
+                for (std::int64_t number : packed->ints()) values_.push_back(encode(std::string_view(), Value(number), arrays));
+                for (double real : packed->doubles()) values_.push_back(encode(std::string_view(), Value(real), arrays));
+            } else {
+                const std::vector<Value>& items = arrays[i]->array_ref();
+                count = items.size();
+                for (const Value& item : items) {
+                    size_t before = arrays.size();
+                    values_.push_back(encode(std::string_view(), item, arrays));
+                    if (arrays.size() != before) array_owner.push_back(values_.size() - 1);
+                }
+            }
+            values_[array_owner[i]].payload = pack(first, narrow(count));
+        }
+
+        Header header{};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = version;
+        header.byte_order = byte_order;
+        header.source_hash = source_hash;
+        header.source_size = source_stamp.size;
+        header.source_mtime_seconds = source_stamp.mtime_seconds;
+        header.source_mtime_nanoseconds = source_stamp.mtime_nanoseconds;
+        header.section_count = narrow(sections_.size());
+        header.value_count = narrow(values_.size());
+        header.string_bytes = strings_.size();
+
+        std::string image(sizeof(Header), '\0');
+        image.append(reinterpret_cast<const char*>(sections_.data()), sections_.size() * sizeof(SectionRecord));
+        image.append(reinterpret_cast<const char*>(values_.data()), values_.size() * sizeof(ValueRecord));
+        image.append(strings_);
+
+        std::string_view payload(image.data() + sizeof(Header), image.size() - sizeof(Header));
+        header.payload_size = payload.size();
+        header.payload_hash = hash_bytes(payload);
+        std::memcpy(&image[0], &header, sizeof(Header));
+        return image;
+    }
+};
+
+// Validates a mapped snapshot and rebuilds the Section tree from it. The
+// records are read straight from the mapping, but every key and string is
+// copied into the new tree, so a load still allocates per value; it saves
+// the tokenizing and number parsing, not the tree construction.
+class Decoder {
+private:
+    const SectionRecord* sections_ = nullptr;
+    const ValueRecord* values_ = nullptr;
+    const char* strings_ = nullptr;
+    Header header_{};
+
+    [[noreturn]] static void corrupt(const std::string& reason) {
+        throw ParseError("Invalid binary snapshot: " + reason);
+    }
+
+    std::string_view string_at(std::uint32_t offset, std::uint32_t size) const {
+        if (static_cast<std::uint64_t>(offset) + size > header_.string_bytes) corrupt("string out of range");
+        return std::string_view(strings_ + offset, size);
+    }
+
+    template <typename Record>
+    static Record load(const void* base, size_t index) {
+        Record record;
+        std::memcpy(&record, static_cast<const char*>(base) + index * sizeof(Record), sizeof(Record));
+        return record;
+    }
+
+    // Records still allowed to be decoded. Arrays and sections may only
+    // point forwards, and no record is decoded more often than the image
+    // has records, so an image whose ranges overlap cannot make decoding
+    // take more than linear work
+    struct Budget {
+        std::uint64_t sections;
+        std::uint64_t values;
+    };
+
+    Value decode(const ValueRecord& record, std::uint32_t index, int depth, Budget& budget) const {
+        if (depth > 256) corrupt("arrays nested too deeply");
+        if (budget.values == 0) corrupt("value records reused");
+        --budget.values;
+        switch (static_cast<TokenKind>(record.kind)) {
+            case TokenKind::String:
+                return Value(std::string(string_at(static_cast<std::uint32_t>(record.payload),
+                                                   static_cast<std::uint32_t>(record.payload >> 32))));
+            case TokenKind::Int: {
+                std::int64_t number;
+                std::memcpy(&number, &record.payload, sizeof(number));
+                return Value(number);
+            }
+            case TokenKind::Double: {
+                double real;
+                std::memcpy(&real, &record.payload, sizeof(real));
+                return Value(real);
+            }
+            case TokenKind::Bool:
+                return Value(record.payload != 0);
+            case TokenKind::Array: {
+                std::uint32_t first = static_cast<std::uint32_t>(record.payload);
+                std::uint32_t count = static_cast<std::uint32_t>(record.payload >> 32);
+                if (static_cast<std::uint64_t>(first) + count > header_.value_count ||
+                    (count > 0 && first <= index)) {
+                    corrupt("array out of range");
+                }
+
+                std::vector<Value> items;
+                items.reserve(count);
+                for (std::uint32_t i = 0; i < count; ++i) {
+                    items.push_back(decode(load<ValueRecord>(values_, first + i), first + i, depth + 1, budget));
+                }
+                return pack_or_box(std::move(items));
+            }
+        }
+        corrupt("unknown value kind");
+    }
+
+    void fill(Section& section, std::uint32_t index, int depth, Budget& budget) const {
+        if (depth > 4096) corrupt("sections nested too deeply");
+        if (budget.sections == 0) corrupt("section records reused");
+        --budget.sections;
+        SectionRecord record = load<SectionRecord>(sections_, index);
+        if (static_cast<std::uint64_t>(record.first_value) + record.value_count > header_.value_count ||
+            static_cast<std::uint64_t>(record.first_child) + record.child_count > header_.section_count ||
+            (record.child_count > 0 && record.first_child <= index)) {
+            corrupt("section out of range");
+        }
+
+        for (std::uint32_t i = 0; i < record.value_count; ++i) {
+            ValueRecord value = load<ValueRecord>(values_, record.first_value + i);
+            section[string_at(value.key_offset, value.key_size)] = decode(value, record.first_value + i, 0, budget);
+        }
+        for (std::uint32_t i = 0; i < record.child_count; ++i) {
+            SectionRecord child = load<SectionRecord>(sections_, record.first_child + i);
+            fill(section.section(string_at(child.name_offset, child.name_size)),
+                 record.first_child + i, depth + 1, budget);
+        }
+    }
+
+public:
+    // Checks the header and checksum of an image
+    explicit Decoder(std::string_view image) {
+        if (image.size() < sizeof(Header)) corrupt("truncated header");
+        std::memcpy(&header_, image.data(), sizeof(Header));
+        if (std::memcmp(header_.magic, magic, sizeof(magic)) != 0) corrupt("bad magic");
+        if (header_.byte_order != byte_order) corrupt("byte order mismatch");
+        if (header_.version != version) corrupt("unsupported version " + std::to_string(header_.version));
+
+        // Each region is checked against what is left before the next one,
+        // so no combination of header counts can wrap around
+        std::string_view payload = image.substr(sizeof(Header));
+        if (header_.payload_size != payload.size()) corrupt("size mismatch");
+        std::uint64_t remaining = payload.size();
+        if (header_.section_count > remaining / sizeof(SectionRecord)) corrupt("size mismatch");
+        remaining -= static_cast<std::uint64_t>(header_.section_count) * sizeof(SectionRecord);
+        if (header_.value_count > remaining / sizeof(ValueRecord)) corrupt("size mismatch");
+        remaining -= static_cast<std::uint64_t>(header_.value_count) * sizeof(ValueRecord);
+        if (header_.string_bytes != remaining) corrupt("size mismatch");
+        if (header_.section_count == 0) corrupt("missing root section");
+        if (hash_bytes(payload) != header_.payload_hash) corrupt("checksum mismatch");
+
+        sections_ = reinterpret_cast<const SectionRecord*>(payload.data());
+        values_ = reinterpret_cast<const ValueRecord*>(payload.data() + header_.section_count * sizeof(SectionRecord));
+        strings_ = payload.data() + header_.section_count * sizeof(SectionRecord) +
+                   header_.value_count * sizeof(ValueRecord);
+    }
+
+    std::uint64_t source_hash() const { return header_.source_hash; }
+
+    // Whether a source was recorded and its stamp still matches
+    bool source_unchanged(const FileStamp& stamp) const {
+        return header_.source_hash != 0 &&
+               FileStamp{header_.source_mtime_seconds, header_.source_mtime_nanoseconds, header_.source_size} == stamp;
+    }
+
+    void decode_into(Section& root) const {
+        Budget budget{header_.section_count, header_.value_count};
+        fill(root, 0, 0, budget);
+    }
+};
+
+} // namespace binary
+} // namespace detail
+
+namespace detail {
+
+// Process-wide cache of parsed fragments for Parser::import(). Entries are
+// keyed by path and revalidated by file stamp, then by content hash, so a
+// fragment shared by many configs is read and parsed once. Cached trees
+// are shared by every mount; Section copies them on first modification.
+class FragmentCache {
+private:
+    struct Entry {
+        FileStamp stamp;
+        std::uint64_t content_hash = 0;
+        std::shared_ptr<const Section> tree;
+    };
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+
+public:
+    static FragmentCache& instance() {
+        static FragmentCache cache;
+        return cache;
+    }
+
+    std::shared_ptr<const Section> load(const std::string& filename) {
+        FileStamp stamp;
+        bool stamped = file_stamp(filename, stamp);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto found = entries_.find(filename);
+            if (stamped && found != entries_.end() && found->second.stamp == stamp) return found->second.tree;
+        }
+
+        FileSource source(filename);
+        std::string buffered;
+        std::string_view content = source.mapped() ? source.view() : std::string_view(buffered = source.read_all());
+        std::uint64_t content_hash = hash_bytes(content);
+        {
+            // Touched but identical: keep the parsed tree
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto found = entries_.find(filename);
+            if (found != entries_.end() && found->second.content_hash == content_hash) {
+                found->second.stamp = stamp;
+                return found->second.tree;
+            }
+        }
+
+        auto tree = std::make_shared<Section>();
+        TreeBuilder builder(*tree);
+        sax_parse(content, builder);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry& entry = entries_[filename];
+        entry.stamp = stamp;
+        entry.content_hash = content_hash;
+        entry.tree = tree;
+        return tree;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+};
+
+} // namespace detail
+
+// Drop every cached fragment; trees already mounted stay valid
+inline void clear_fragment_cache() { detail::FragmentCache::instance().clear(); }
+inline size_t fragment_cache_size() { return detail::FragmentCache::instance().size(); }
+
+namespace detail {
+
+inline size_t worker_count(size_t requested, size_t jobs) {
+    size_t count = requested != 0 ? requested : std::thread::hardware_concurrency();
+    if (count == 0) count = 1;
+    return std::min(count, jobs);
+}
+
+// Runs fn(i) for every i in [0, count) on up to `threads` threads. The
+// exception from the lowest failing index is rethrown after all workers
+// have joined.
+template <typename Fn>
+void parallel_for(size_t count, size_t threads, Fn fn) {
+    if (count == 0) return;
+    std::vector<std::exception_ptr> errors(count);
+    std::atomic<size_t> next{0};
+
+    auto work = [&]() {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            try {
+                fn(i);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    size_t workers = worker_count(threads, count);
+    pool.reserve(workers - 1);
+    for (size_t i = 1; i < workers; ++i) pool.emplace_back(work);
+    work();
+    for (std::thread& thread : pool) thread.join();
+
+    for (const std::exception_ptr& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+// Splits input into at most `parts` pieces of similar size. Cuts are only
+// made before top-level "^" headers that start a line outside comments,
+// so every piece parses independently to the same sections.
+inline std::vector<std::string_view> split_top_level(std::string_view content, size_t parts) {
+    std::vector<std::string_view> pieces;
+    size_t target = parts > 1 ? content.size() / parts : content.size();
+    size_t piece_start = 0;
+
+    enum class State { Text, LineComment, BlockComment };
+    State state = State::Text;
+    bool line_start = true;
+    size_t line_text = 0;         // First non-blank byte of the current line
+    bool leading_comment = false;  // Block comment with only blanks before it
+
+    for (size_t i = 0; i < content.size(); ++i) {
+        if (state == State::LineComment) {
+            i = content.find('\n', i);
+            if (i == std::string_view::npos) break;
+            state = State::Text;
+            line_start = true;
+            continue;
+        }
+        if (state == State::BlockComment) {
+            i = content.find("*/", i);
+            if (i == std::string_view::npos) break;
+            state = State::Text;
+            ++i;
+            // A header may follow the comment on its closing line
+            line_start = leading_comment;
+            continue;
+        }
+
+        if (line_start) {
+            size_t first = i;
+            while (first < content.size() && (content[first] == ' ' || content[first] == '\t' || content[first] == '\r')) {
+                ++first;
+            }
+            bool top_header = first < content.size() && content[first] == '^' &&
+                              (first + 1 == content.size() || content[first + 1] != '^');
+            if (top_header && i - piece_start >= target && pieces.size() + 1 < parts) {
+                pieces.push_back(content.substr(piece_start, i - piece_start));
+                piece_start = i;
+            }
+            line_text = first;
+            line_start = false;
+        }
+
+        i = find_either(content.data(), i, content.size(), '\n', '/');
+        if (i == content.size()) break;
+        char c = content[i];
+        if (c == '\n') {
+            line_start = true;
+        } else if (c == '/' && i + 1 < content.size() && (content[i + 1] == '/' || content[i + 1] == '*')) {
+            state = content[i + 1] == '/' ? State::LineComment : State::BlockComment;
+            leading_comment = i == line_text;
+            ++i;
+        }
+    }
+
+    pieces.push_back(content.substr(piece_start));
+    return pieces;
+}
+
+} // namespace detail
+
+// Main YINI parser/writer class
+class Parser {
+private:
+    Section root_;
+
+    // State of an in-progress feed()/finish() parse
+    struct Stream {
+        detail::TreeBuilder builder;
+        EventReader<detail::TreeBuilder> reader;
+
+        explicit Stream(Section& root) : builder(root), reader(builder) {}
+    };
+    std::unique_ptr<Stream> stream_;
+
+public:
+    Parser() = default;
+
+    // A feed() in progress moves with the parser. Not noexcept: moving a
+    // Section may allocate (std::deque does in libstdc++)
+    Parser(Parser&& other) : root_(std::move(other.root_)), stream_(std::move(other.stream_)) {
+        if (stream_) stream_->builder.rebase(root_);
+    }
+
+    Parser& operator=(Parser&& other) noexcept {
+        static_assert(std::is_nothrow_move_assignable<Section>::value &&
+                      std::is_nothrow_move_assignable<std::unique_ptr<Stream>>::value,
+                      "Parser move assignment is noexcept");
+        root_ = std::move(other.root_);
+        stream_ = std::move(other.stream_);
+        if (stream_) stream_->builder.rebase(root_);
+        return *this;
+    }
+
+    // Parse from file
+    void parse_file(const std::string& filename) {
+        detail::FileSource source(filename);
+        if (source.mapped()) {
+            parse(source.view());
+            return;
+        }
+
+        stream_.reset();
+        std::vector<char> chunk(detail::FileSource::chunk_size);
+        while (size_t got = source.read(chunk.data(), chunk.size())) {
+            feed(chunk.data(), got);
+        }
+        finish();
+    }
+
+    // Parse a large document on several threads. The input is cut before
+    // top-level "^" headers and the pieces are merged in source order, so
+    // the result matches parse(). threads = 0 uses every hardware thread.
+    void parse_parallel(std::string_view content, size_t threads = 0) {
+        size_t workers = detail::worker_count(threads, std::max<size_t>(content.size() / (64 * 1024), 1));
+        if (workers <= 1) {
+            // Small input or one thread: splitting and merging only costs
+            parse(content);
+            return;
+        }
+        std::vector<std::string_view> pieces = detail::split_top_level(content, workers * 4);
+        if (pieces.size() < 2) {
+            parse(content);
+            return;
+        }
+
+        std::vector<Section> trees(pieces.size());
+        try {
+            detail::parallel_for(pieces.size(), workers, [&](size_t i) {
+                detail::TreeBuilder builder(trees[i]);
+                sax_parse(pieces[i], builder);
+            });
+        } catch (const ParseError&) {
+            // Line numbers are relative to a piece; re-parse to report the
+            // error against the whole input
+            parse(content);
+            throw;
+        }
+
+        stream_.reset();
+        root_.clear();
+        for (Section& tree : trees) {
+            root_.merge(std::move(tree));
+        }
+    }
+
+    void parse_file_parallel(const std::string& filename, size_t threads = 0) {
+        detail::FileSource source(filename);
+        if (source.mapped()) {
+            parse_parallel(source.view(), threads);
+        } else {
+            std::string content = source.read_all();
+            parse_parallel(content, threads);
+        }
+    }
+
+    // Parse from string
+    void parse_string(const std::string& content) {
+        parse(std::string_view(content));
+    }
+
+    // Instrumented variants; stats is reset and then filled in
+    void parse_string(const std::string& content, ParseStats& stats) {
+        parse(std::string_view(content), stats);
+    }
+
+    void parse_file(const std::string& filename, ParseStats& stats) {
+        detail::FileSource source(filename);
+        if (source.mapped()) {
+            parse(source.view(), stats);
+        } else {
+            std::string content = source.read_all();
+            parse(std::string_view(content), stats);
+        }
+    }
+
+    void parse(std::string_view content, ParseStats& stats) {
+        using Clock = std::chrono::steady_clock;
+
+        std::function<std::uint64_t()> allocation_counter = std::move(stats.allocation_counter);
+        std::function<void(std::string_view, bool)> trace = std::move(stats.trace);
+        stats = ParseStats();
+        stats.allocation_counter = std::move(allocation_counter);
+        stats.trace = std::move(trace);
+
+        stats.bytes = content.size();
+        stats.lines = static_cast<size_t>(std::count(content.begin(), content.end(), '\n'));
+        if (!content.empty() && content.back() != '\n') ++stats.lines;
+
+        if (stats.trace) stats.trace("parse", true);
+        std::uint64_t allocations_before = stats.allocation_counter ? stats.allocation_counter() : 0;
+        Clock::time_point start = Clock::now();
+
+        stream_.reset();
+        root_.clear();
+        detail::StatsBuilder builder(root_, stats);
+        try {
+            sax_parse(content, builder);
+        } catch (...) {
+            if (stats.trace) stats.trace("parse", false);
+            throw;
+        }
+
+        stats.total = Clock::now() - start;
+        stats.lexing = stats.total - stats.value_parsing - stats.tree_building;
+        if (stats.allocation_counter) stats.allocations = stats.allocation_counter() - allocations_before;
+        if (stats.trace) stats.trace("parse", false);
+    }
+
+    // Parse from a view; nothing is copied until values are stored
+    void parse(std::string_view content) {
+        stream_.reset();
+        root_.clear();
+
+        detail::TreeBuilder builder(root_);
+        sax_parse(content, builder);
+    }
+
+    // Push parsing: feed() input as it arrives, then call finish(). The first
+    // feed() clears the current contents; sections and values are applied as
+    // soon as their line is complete, and only a partial line is buffered.
+    void feed(const char* data, size_t size) {
+        if (!stream_) {
+            root_.clear();
+            stream_ = std::make_unique<Stream>(root_);
+        }
+
+        try {
+            stream_->reader.feed(data, size);
+        } catch (...) {
+            stream_.reset();
+            throw;
+        }
+    }
+
+    void feed(std::string_view chunk) { feed(chunk.data(), chunk.size()); }
+
+    void finish() {
+        if (!stream_) {
+            root_.clear();
+            return;
+        }
+
+        std::unique_ptr<Stream> stream = std::move(stream_);
+        stream->reader.finish();
+    }
+
+    // Write to file
+    void write_file(const std::string& filename) const {
+        // Stream into a temporary so a serialisation or I/O error leaves
+        // the existing file untouched
+        detail::FileReplacement file(filename);
+        Writer writer([&file](const char* data, size_t size) { file.write(data, size); });
+        write_to(writer);
+        writer.flush();
+        file.commit();
+    }
+
+    // Write the file only if its current contents differ from the output,
+    // so unchanged files keep their timestamps. Returns true if written.
+    bool write_file_if_changed(const std::string& filename) const {
+        std::string output = write_string();
+        try {
+            detail::FileSource existing(filename);
+            std::string buffered;
+            std::string_view current = existing.mapped() ? existing.view() : std::string_view(buffered = existing.read_all());
+            if (current == output) return false;
+        } catch (const FileError&) {
+            // Missing or unreadable: write it
+        }
+
+        // Replaced as a whole, as write_file() does
+        detail::FileReplacement file(filename);
+        file.write(output.data(), output.size());
+        file.commit();
+        return true;
+    }
+
+    // Hash of the serialized output. Section order is insertion order and
+    // the hash is the library's own, so equal trees give equal hashes on
+    // every platform; use it to cache or skip uploads.
+    std::uint64_t content_hash() const {
+        Writer writer;
+        write_to(writer);
+        return detail::hash_bytes(writer.view());
+    }
+
+    // Write to string
+    std::string write_string() const {
+        Writer writer;
+        write_to(writer);
+        return writer.take();
+    }
+
+    // Write to stream
+    void write_stream(std::ostream& out) const {
+        Writer writer([&out](const char* data, size_t size) {
+            out.write(data, static_cast<std::streamsize>(size));
+        });
+        write_to(writer);
+        writer.flush();
+    }
+
+    // Append to a reusable writer
+    void write_to(Writer& writer) const {
+        writer.write(root_);
+    }
+
+    // Write a compiled binary snapshot (.yinib). When source_filename is
+    // given, the stamp and hash of that text file are recorded so
+    // load_binary() can tell when the snapshot is stale.
+    void save_binary(const std::string& filename, const std::string& source_filename = {}) const {
+        std::uint64_t source_hash = 0;
+        detail::FileStamp source_stamp;
+        if (!source_filename.empty()) {
+            // Stamp first: a write racing the read then leaves a mismatch
+            if (!detail::file_stamp(source_filename, source_stamp)) source_stamp = detail::FileStamp{};
+            detail::FileSource source(source_filename);
+            std::string buffered;
+            source_hash = detail::hash_bytes(source.mapped() ? source.view() : std::string_view(buffered = source.read_all()));
+        }
+
+        std::string image = detail::binary::Encoder().encode(root_, source_hash, source_stamp);
+        detail::FileSink file(filename);
+        file.write(image.data(), image.size());
+    }
+
+    // Load a binary snapshot; throws ParseError if it is corrupt or from an
+    // incompatible version. The image is validated in place and decoded
+    // into an ordinary Section tree.
+    void load_binary(const std::string& filename) {
+        detail::FileSource source(filename);
+        std::string buffered;
+        std::string_view image = source.mapped() ? source.view() : std::string_view(buffered = source.read_all());
+
+        // Decode aside so a corrupt image leaves the current tree intact
+        Section decoded;
+        detail::binary::Decoder(image).decode_into(decoded);
+        stream_.reset();
+        root_ = std::move(decoded);
+    }
+
+    // Load a snapshot if it is intact and was built from the current
+    // contents of source_filename; otherwise parse the text file. Returns
+    // true when the snapshot was used. The text is read and hashed only
+    // when its size or mtime differ from the recorded ones, so a rewrite
+    // that keeps both goes unnoticed.
+    bool load_binary(const std::string& filename, const std::string& source_filename) {
+        detail::FileStamp stamp;
+        bool stamped = detail::file_stamp(source_filename, stamp);
+        detail::FileSource text(source_filename);
+        std::string text_buffer;
+        std::string_view content;
+        bool content_read = false;
+        auto read_content = [&]() {
+            if (!content_read) {
+                content = text.mapped() ? text.view() : std::string_view(text_buffer = text.read_all());
+                content_read = true;
+            }
+            return content;
+        };
+
+        try {
+            detail::FileSource source(filename);
+            std::string buffered;
+            std::string_view image = source.mapped() ? source.view() : std::string_view(buffered = source.read_all());
+
+            detail::binary::Decoder decoder(image);
+            if ((stamped && decoder.source_unchanged(stamp)) ||
+                decoder.source_hash() == detail::hash_bytes(read_content())) {
+                Section decoded;
+                decoder.decode_into(decoded);
+                stream_.reset();
+                root_ = std::move(decoded);
+                return true;
+            }
+        } catch (const FileError&) {
+        } catch (const ParseError&) {
+        }
+
+        parse(read_content());
+        return false;
+    }
+
+    // Cheap copy for building variants of a base document. Subsections are
+    // shared with this parser and cloned only along paths either side
+    // later modifies.
+    Parser clone() const {
+        Parser copy;
+        copy.root_ = root_.clone();
+        return copy;
+    }
+
+    // Apply an override document on top of the current tree without
+    // clearing it: its values replace existing ones and its sections are
+    // merged into existing sections. If the text fails to parse, the
+    // overrides before the error remain applied.
+    void overlay(std::string_view content) {
+        stream_.reset();
+        detail::TreeBuilder builder(root_);
+        sax_parse(content, builder);
+    }
+
+    void overlay_file(const std::string& filename) {
+        detail::FileSource source(filename);
+        if (source.mapped()) {
+            overlay(source.view());
+        } else {
+            std::string content = source.read_all();
+            overlay(std::string_view(content));
+        }
+    }
+
+    // Mount a parsed file at a dotted section path ("shared.db"), creating
+    // missing parents. The fragment comes from the process-wide cache and
+    // its tree is shared with every other mount, not copied; a section
+    // already at the mount point is replaced. An empty mount point merges
+    // the fragment into the root as merge() does: sections the root lacks
+    // are shared, same-named ones are merged key by key.
+    const Section& import(const std::string& filename, std::string_view mount_point) {
+        std::shared_ptr<const Section> fragment = detail::FragmentCache::instance().load(filename);
+
+        if (mount_point.empty()) {
+            root_.merge(*fragment);
+            return root_;
+        }
+
+        Section* parent = &root_;
+        size_t start = 0;
+        size_t dot;
+        while ((dot = mount_point.find('.', start)) != std::string_view::npos) {
+            parent = &parent->section(mount_point.substr(start, dot - start));
+            start = dot + 1;
+        }
+        parent->attach(mount_point.substr(start), fragment);
+        return *fragment;
+    }
+
+    // Build an immutable snapshot of the current tree for lock-free reads
+    FrozenDocument freeze() const {
+        return FrozenDocument(root_);
     }
 
     // Access root section
     Section& root() { return root_; }
     const Section& root() const { return root_; }
 
-    // Convenience accessors
-    Value& operator[](const std::string& key) { return root_[key]; }
-    Section& section(const std::string& name) { return root_.section(name); }
+    // Convenience accessors
+    Value& operator[](std::string_view key) { return root_[key]; }
+    Value& operator[](Atom key) { return root_[key]; }
+    Section& section(std::string_view name) { return root_.section(name); }
+    Section& section(Atom name) { return root_.section(name); }
+    const Value* find(std::string_view path) const { return root_.find(path); }
+    const Value* find(const Path& path) const { return root_.find(path); }
+};
+
+// Parse many files concurrently and merge them in the order given; values
+// from later files override earlier ones. threads = 0 uses every hardware
+// thread. The first failing file (in list order) has its error rethrown.
+inline Parser parse_files_parallel(const std::vector<std::string>& paths, size_t threads = 0) {
+    std::vector<Parser> parsed(paths.size());
+    detail::parallel_for(paths.size(), threads, [&](size_t i) {
+        parsed[i].parse_file(paths[i]);
+    });
+
+    Parser merged;
+    for (Parser& part : parsed) {
+        merged.root().merge(std::move(part.root()));
+    }
+    return merged;
+}
+
+// Parses top-level sections on first use. parse() only records where each
+// top-level "^" section starts and ends (plus the root values before the
+// first header); get_section() tokenizes a section the first time it is
+// asked for. Access is thread-safe: each section is built once under
+// std::call_once, and a failed build is retried on the next access.
+class LazyDocument {
+private:
+    struct Entry {
+        std::string name;
+        std::vector<std::string_view> ranges;  // Every place the section is opened
+        std::once_flag once;
+        std::shared_ptr<const Section> section;
+    };
+
+    std::string owned_;
+    std::unique_ptr<detail::FileSource> source_;
+    std::string_view content_;
+    Section root_;
+    mutable std::deque<Entry> entries_;
+    detail::StringMap<size_t> index_;
+
+    void build(Entry& entry) const {
+        try {
+            Section scratch;
+            detail::TreeBuilder builder(scratch);
+            for (std::string_view range : entry.ranges) sax_parse(range, builder);
+
+            auto child = scratch.sections_begin();
+            std::shared_ptr<const Section> section;
+            if (child != scratch.sections_end()) {
+                section = child->second;
+            } else {
+                section = std::make_shared<Section>();
+            }
+            std::atomic_store(&entry.section, std::move(section));
+        } catch (const ParseError&) {
+            // Line numbers are relative to the range; re-scan from the start
+            // of the file so the error names the right line
+            std::string_view last = entry.ranges.back();
+            Visitor validator;
+            sax_parse(content_.substr(0, static_cast<size_t>(last.data() + last.size() - content_.data())), validator);
+            throw;
+        }
+    }
+
+    void index(std::string_view content) {
+        content_ = content;
+        root_.clear();
+        entries_.clear();
+        index_.clear();
+
+        std::vector<std::string_view> pieces = detail::split_top_level(content, std::numeric_limits<size_t>::max());
+        detail::TreeBuilder builder(root_);
+        sax_parse(pieces[0], builder);
+
+        for (size_t i = 1; i < pieces.size(); ++i) {
+            // Only the header line is lexed now
+            Lexer lexer(pieces[i]);
+            Token token;
+            lexer.next(token);
+            std::string_view name = token.name;
+
+            auto [slot, inserted] = index_.try_emplace(name);
+            if (inserted) {
+                *slot = entries_.size();
+                entries_.emplace_back();
+                entries_.back().name.assign(name.data(), name.size());
+            }
+            entries_[*slot].ranges.push_back(pieces[i]);
+        }
+    }
+
+public:
+    LazyDocument() = default;
+    LazyDocument(const LazyDocument&) = delete;
+    LazyDocument& operator=(const LazyDocument&) = delete;
+
+    // The view must outlive the document
+    void parse(std::string_view content) {
+        source_.reset();
+        owned_.clear();
+        index(content);
+    }
+
+    void parse_string(std::string content) {
+        source_.reset();
+        owned_ = std::move(content);
+        index(owned_);
+    }
+
+    // Mapped files stay mapped for the lifetime of the document
+    void parse_file(const std::string& filename) {
+        auto source = std::make_unique<detail::FileSource>(filename);
+        if (source->mapped()) {
+            owned_.clear();
+            std::string_view view = source->view();
+            source_ = std::move(source);
+            index(view);
+        } else {
+            parse_string(source->read_all());
+        }
+    }
+
+    // Root-level values; top-level sections are reached through get_section()
+    const Section& root() const { return root_; }
+    const Value& at(std::string_view key) const { return root_.at(key); }
+
+    bool has_section(std::string_view name) const { return index_.find(name) != nullptr; }
+
+    // Builds the section on first access; nullptr if there is none
+    const Section* find_section(std::string_view name) const {
+        const size_t* slot = index_.find(name);
+        if (!slot) return nullptr;
+        Entry& entry = entries_[*slot];
+        std::call_once(entry.once, [this, &entry]() { build(entry); });
+        return entry.section.get();
+    }
+
+    const Section& get_section(std::string_view name) const {
+        const Section* section = find_section(name);
+        if (!section) {
+            throw std::out_of_range("Section not found: " + std::string(name));
+        }
+        return *section;
+    }
+
+    // Dotted-path lookup; only the first segment's section is built
+    const Value* find(std::string_view path) const {
+        size_t dot = path.find('.');
+        if (dot == std::string_view::npos) return root_.find(path);
+        const Section* section = find_section(path.substr(0, dot));
+        return section ? section->find(path.substr(dot + 1)) : nullptr;
+    }
+
+    // Top-level section names in source order
+    std::vector<std::string_view> section_names() const {
+        std::vector<std::string_view> names;
+        names.reserve(entries_.size());
+        for (const Entry& entry : entries_) names.push_back(entry.name);
+        return names;
+    }
+
+    // Number of top-level sections built so far
+    size_t materialized() const {
+        size_t count = 0;
+        for (const Entry& entry : entries_) {
+            if (std::atomic_load(&entry.section)) ++count;
+        }
+        return count;
+    }
+};
+
+// Immutable, reference-counted view of a parsed tree. Copies are cheap and
+// every accessor is const, so a snapshot can be read from any thread while
+// newer snapshots are published.
+class Snapshot {
+private:
+    std::shared_ptr<const Section> root_;
+
+public:
+    Snapshot() : root_(std::make_shared<Section>()) {}
+    explicit Snapshot(std::shared_ptr<const Section> root)
+        : root_(root ? std::move(root) : std::make_shared<Section>()) {}
+
+    const Section& root() const { return *root_; }
+    const std::shared_ptr<const Section>& shared() const { return root_; }
+
+    const Value* find(std::string_view path) const { return root_->find(path); }
+    const Value* find(const Path& path) const { return root_->find(path); }
+    const Value& at(std::string_view key) const { return root_->at(key); }
+    const Section& get_section(std::string_view name) const { return root_->get_section(name); }
+    bool has_section(std::string_view name) const { return root_->has_section(name); }
+};
+
+// Holder that publishes snapshots to concurrent readers. update() swaps in
+// a new tree and bumps a version counter. Readers read through a
+// Config::Reader, one per thread: it re-reads the tree only when the
+// version moves, so a read between updates is one atomic load of the
+// counter and never takes a lock. Config::load() is a convenience for
+// occasional reads; it goes through std::atomic_load on the shared
+// pointer, which libstdc++ and MSVC guard with a pool of internal locks.
+class Config {
+private:
+    std::shared_ptr<const Section> root_;
+    std::atomic<std::uint64_t> version_{0};
+
+public:
+    Config() : root_(std::make_shared<Section>()) {}
+    explicit Config(Section&& root) : root_(std::make_shared<Section>(std::move(root))) {}
+
+    Config(const Config&) = delete;
+    Config& operator=(const Config&) = delete;
+
+    // Current snapshot for one-off reads; may take a library lock, so
+    // loops and hot paths use a Reader instead
+    Snapshot load() const { return Snapshot(std::atomic_load(&root_)); }
+
+    // The read API: a per-reader cache of the latest snapshot. Keep one per
+    // thread; it must not outlive its Config. Only the first load() after
+    // an update goes through Config::load(). The cached snapshot keeps its
+    // tree alive until the reader sees a newer version or is destroyed.
+    class Reader {
+    private:
+        const Config* config_;
+        std::uint64_t version_;
+        Snapshot snapshot_;
+
+    public:
+        explicit Reader(const Config& config)
+            : config_(&config), version_(config.version()), snapshot_(config.load()) {}
+
+        const Snapshot& load() {
+            std::uint64_t version = config_->version();
+            if (version != version_) {
+                // The tree is stored before the counter moves, so this
+                // snapshot is at least as new as version
+                snapshot_ = config_->load();
+                version_ = version;
+            }
+            return snapshot_;
+        }
+    };
+
+    // Publish a new tree; readers pick it up on their next load()
+    void update(std::shared_ptr<const Section> root) {
+        if (!root) root = std::make_shared<Section>();
+        std::atomic_store(&root_, std::move(root));
+        version_.fetch_add(1, std::memory_order_release);
+    }
+
+    void update(Section&& root) { update(std::make_shared<Section>(std::move(root))); }
+
+    // Number of updates published so far
+    std::uint64_t version() const { return version_.load(std::memory_order_acquire); }
+};
+
+// Stack of documents where later layers override earlier ones (defaults,
+// region, host, environment). Every dotted key path is resolved when the
+// stack is built and kept in one flat index, so a lookup is a single hash
+// probe however many layers there are. Layers are shared and must not be
+// modified while they are part of the stack; replace one with set_layer().
+// Keys and sections whose names contain a dot are indexed by their exact
+// names; a path spelled the same way by two different nestings is
+// ambiguous and holds whichever was indexed last.
+class Layered {
+private:
+    struct Resolved {
+        const Value* value = nullptr;  // nullptr once no layer has the key
+        size_t layer = 0;
+    };
+
+    std::vector<std::shared_ptr<const Section>> layers_;
+    detail::StringMap<Resolved> index_;
+    size_t resolved_ = 0;
+
+    // Calls fn(path, segments, value) for every key under before or after,
+    // skipping subtrees the two share. path joins the segments with '.';
+    // the segments are the exact names, which may themselves contain dots.
+    // value is the key's value on the side being visited. Keys may be
+    // reported twice.
+    template <typename Fn>
+    static void changed_paths(const Section* before, const Section* after, std::string& path,
+                              std::vector<std::string_view>& segments, Fn& fn) {
+        if (before == after) return;
+        size_t length = path.size();
+        for (const Section* side : {before, after}) {
+            if (!side) continue;
+            for (auto it = side->values_begin(); it != side->values_end(); ++it) {
+                path.resize(length);
+                path += it->first;
+                segments.push_back(it->first);
+                fn(std::string_view(path), segments, &it->second);
+                segments.pop_back();
+            }
+        }
+        if (after) {
+            for (auto it = after->sections_begin(); it != after->sections_end(); ++it) {
+                path.resize(length);
+                path += it->first;
+                path += '.';
+                segments.push_back(it->first);
+                changed_paths(before ? before->find_section(it->first) : nullptr, it->second.get(), path, segments, fn);
+                segments.pop_back();
+            }
+        }
+        if (before) {
+            for (auto it = before->sections_begin(); it != before->sections_end(); ++it) {
+                if (after && after->has_section(it->first)) continue;
+                path.resize(length);
+                path += it->first;
+                path += '.';
+                segments.push_back(it->first);
+                changed_paths(it->second.get(), nullptr, path, segments, fn);
+                segments.pop_back();
+            }
+        }
+        path.resize(length);
+    }
+
+    // Follows the exact segment names; Section::find() would split a name
+    // that contains a dot
+    static const Value* lookup(const Section& layer, const std::vector<std::string_view>& segments) {
+        const Section* current = &layer;
+        for (size_t i = 0; i + 1 < segments.size(); ++i) {
+            current = current->find_section(segments[i]);
+            if (!current) return nullptr;
+        }
+        return current->find_value(segments.back());
+    }
+
+    void assign(std::string_view path, const Value* value, size_t layer) {
+        Resolved& resolved = *index_.try_emplace(path).first;
+        if (!resolved.value && value) ++resolved_;
+        if (resolved.value && !value) --resolved_;
+        resolved.value = value;
+        resolved.layer = layer;
+    }
+
+    // Re-resolve one key from the top layer down
+    void resolve(std::string_view path, const std::vector<std::string_view>& segments) {
+        for (size_t i = layers_.size(); i-- > 0;) {
+            if (const Value* value = lookup(*layers_[i], segments)) {
+                assign(path, value, i);
+                return;
+            }
+        }
+        assign(path, nullptr, 0);
+    }
+
+public:
+    Layered() = default;
+
+    // Lowest priority first
+    explicit Layered(std::vector<std::shared_ptr<const Section>> layers) {
+        for (auto& layer : layers) push_layer(std::move(layer));
+    }
+
+    // Add a layer that overrides every existing one
+    void push_layer(std::shared_ptr<const Section> layer) {
+        if (!layer) layer = std::make_shared<Section>();
+        layers_.push_back(std::move(layer));
+        size_t index = layers_.size() - 1;
+        const Section* top = layers_.back().get();
+
+        std::string path;
+        std::vector<std::string_view> segments;
+        auto apply = [&](std::string_view key, const std::vector<std::string_view>&, const Value* value) {
+            assign(key, value, index);
+        };
+        changed_paths(nullptr, top, path, segments, apply);
+    }
+
+    // Replace one layer. Only paths under the subtrees that differ between
+    // the old and new layer are re-resolved, so a layer rebuilt with
+    // Section::clone() and a small overlay costs little.
+    void set_layer(size_t index, std::shared_ptr<const Section> layer) {
+        if (index >= layers_.size()) {
+            throw std::out_of_range("Layer index out of range: " + std::to_string(index));
+        }
+        if (!layer) layer = std::make_shared<Section>();
+        std::shared_ptr<const Section> previous = std::move(layers_[index]);
+        layers_[index] = std::move(layer);
+
+        std::string path;
+        std::vector<std::string_view> segments;
+        auto refresh = [&](std::string_view key, const std::vector<std::string_view>& names, const Value*) {
+            resolve(key, names);
+        };
+        changed_paths(previous.get(), layers_[index].get(), path, segments, refresh);
+    }
+
+    size_t layer_count() const { return layers_.size(); }
+    const Section& layer(size_t index) const { return *layers_.at(index); }
+
+    // Resolved value for a dotted path, or nullptr
+    const Value* find(std::string_view path) const {
+        const Resolved* resolved = index_.find(path);
+        return resolved ? resolved->value : nullptr;
+    }
+
+    const Value& at(std::string_view path) const {
+        const Value* value = find(path);
+        if (!value) {
+            throw std::out_of_range("Key not found: " + std::string(path));
+        }
+        return *value;
+    }
+
+    bool has_value(std::string_view path) const { return find(path) != nullptr; }
+
+    // Index of the layer that supplies path
+    size_t layer_of(std::string_view path) const {
+        const Resolved* resolved = index_.find(path);
+        if (!resolved || !resolved->value) {
+            throw std::out_of_range("Key not found: " + std::string(path));
+        }
+        return resolved->layer;
+    }
+
+    // Number of resolvable key paths
+    size_t size() const { return resolved_; }
+};
+
+// Compile-time struct binding. YINI_REFLECT(Type, field...) lists the
+// members that map to keys; members whose type is itself reflected map to
+// subsections of the same name. Use it at namespace scope, in the namespace
+// of Type, so the generated yini_reflect() is found by argument-dependent
+// lookup. Up to 32 fields are supported.
+//
+//   struct Server { std::string host; int port = 0; };
+//   YINI_REFLECT(Server, host, port)
+//
+// yini::decode<T>() fills a struct straight from the SAX events and
+// yini::encode() writes one through a Writer; no Section tree is built.
+#define YINI_REFLECT(Type, ...)                                                 \
+    constexpr auto yini_reflect(const Type*) {                                  \
+        using yini_reflected_type = Type;                                       \
+        return std::make_tuple(YINI_DETAIL_FOR_EACH(YINI_DETAIL_FIELD, __VA_ARGS__)); \
+    }
+
+#define YINI_DETAIL_FIELD(member) ::yini::detail::make_field(#member, &yini_reflected_type::member)
+
+#define YINI_DETAIL_EXPAND(x) x
+#define YINI_DETAIL_FE_1(m, x) m(x)
+#define YINI_DETAIL_FE_2(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_1(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_3(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_2(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_4(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_3(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_5(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_4(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_6(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_5(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_7(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_6(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_8(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_7(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_9(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_8(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_10(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_9(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_11(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_10(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_12(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_11(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_13(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_12(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_14(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_13(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_15(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_14(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_16(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_15(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_17(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_16(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_18(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_17(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_19(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_18(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_20(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_19(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_21(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_20(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_22(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_21(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_23(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_22(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_24(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_23(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_25(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_24(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_26(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_25(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_27(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_26(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_28(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_27(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_29(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_28(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_30(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_29(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_31(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_30(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_32(m, x, ...) m(x), YINI_DETAIL_EXPAND(YINI_DETAIL_FE_31(m, __VA_ARGS__))
+#define YINI_DETAIL_FE_PICK(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, \
+    _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, NAME, ...) NAME
+#define YINI_DETAIL_FOR_EACH(m, ...) \
+    YINI_DETAIL_EXPAND(YINI_DETAIL_FE_PICK(__VA_ARGS__, YINI_DETAIL_FE_32, YINI_DETAIL_FE_31, \
+    YINI_DETAIL_FE_30, YINI_DETAIL_FE_29, YINI_DETAIL_FE_28, YINI_DETAIL_FE_27, YINI_DETAIL_FE_26, \
+    YINI_DETAIL_FE_25, YINI_DETAIL_FE_24, YINI_DETAIL_FE_23, YINI_DETAIL_FE_22, YINI_DETAIL_FE_21, \
+    YINI_DETAIL_FE_20, YINI_DETAIL_FE_19, YINI_DETAIL_FE_18, YINI_DETAIL_FE_17, YINI_DETAIL_FE_16, \
+    YINI_DETAIL_FE_15, YINI_DETAIL_FE_14, YINI_DETAIL_FE_13, YINI_DETAIL_FE_12, YINI_DETAIL_FE_11, \
+    YINI_DETAIL_FE_10, YINI_DETAIL_FE_9, YINI_DETAIL_FE_8, YINI_DETAIL_FE_7, YINI_DETAIL_FE_6, \
+    YINI_DETAIL_FE_5, YINI_DETAIL_FE_4, YINI_DETAIL_FE_3, YINI_DETAIL_FE_2, YINI_DETAIL_FE_1)(m, __VA_ARGS__))
+
+namespace detail {
+
+// FNV-1a, usable in constant expressions for the field tables
+constexpr std::uint64_t key_hash(std::string_view key) {
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char c : key) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+template <typename Owner, typename Member>
+struct Field {
+    std::string_view name;
+    std::uint64_t hash;
+    Member Owner::*member;
+};
+
+template <typename Owner, typename Member>
+constexpr Field<Owner, Member> make_field(std::string_view name, Member Owner::*member) {
+    return Field<Owner, Member>{name, key_hash(name), member};
+}
+
+template <typename T, typename = void>
+struct is_reflected : std::false_type {};
+
+template <typename T>
+struct is_reflected<T, std::void_t<decltype(yini_reflect(static_cast<const T*>(nullptr)))>> : std::true_type {};
+
+template <typename T>
+constexpr auto fields_of() {
+    return yini_reflect(static_cast<const T*>(nullptr));
+}
+
+template <typename T>
+struct is_vector : std::false_type {};
+
+template <typename T>
+struct is_vector<std::vector<T>> : std::true_type {};
+
+[[noreturn]] inline void type_mismatch(std::string_view key, const char* expected) {
+    throw ParseError("Type mismatch for key '" + std::string(key) + "': expected " + expected);
+}
+
+// Converts one token into a bound member
+template <typename T>
+void decode_scalar(T& out, TokenKind kind, std::string_view raw, std::string_view key) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        if (kind == TokenKind::Array) type_mismatch(key, "a string");
+        out.assign(raw.data(), raw.size());
+    } else if constexpr (std::is_same_v<T, bool>) {
+        if (kind != TokenKind::Bool || !parse_bool(raw, out)) type_mismatch(key, "a bool");
+    } else if constexpr (std::is_integral_v<T>) {
+        if (kind != TokenKind::Int || !parse_int(raw, out)) type_mismatch(key, "an integer in range");
+    } else if constexpr (std::is_floating_point_v<T>) {
+        double result = 0.0;
+        if ((kind != TokenKind::Int && kind != TokenKind::Double) || !parse_double(raw, result)) {
+            type_mismatch(key, "a number");
+        }
+        out = static_cast<T>(result);
+    } else if constexpr (std::is_same_v<T, Value>) {
+        out = make_value(kind, raw);
+    } else if constexpr (is_vector<T>::value) {
+        if (kind != TokenKind::Array) type_mismatch(key, "an array");
+        out.clear();
+        for_each_element(raw, [&](TokenKind item_kind, std::string_view item) {
+            out.emplace_back();
+            decode_scalar(out.back(), item_kind, item, key);
+        });
+    } else {
+        static_assert(sizeof(T) == 0, "unsupported member type for YINI_REFLECT");
+    }
+}
+
+// Type-erased handle on the struct that receives the current section
+struct BindFrame {
+    void* object = nullptr;
+    void (*assign)(void* object, std::string_view key, TokenKind kind, std::string_view raw) = nullptr;
+    BindFrame (*child)(void* object, std::string_view name) = nullptr;
+};
+
+template <typename T>
+BindFrame bind_frame(T& object);
+
+template <typename T>
+void assign_field(void* object, std::string_view key, TokenKind kind, std::string_view raw) {
+    T& target = *static_cast<T*>(object);
+    const std::uint64_t hash = key_hash(key);
+    bool done = false;
+    std::apply([&](const auto&... field) {
+        auto visit = [&](const auto& f) {
+            using Member = std::remove_reference_t<decltype(target.*(f.member))>;
+            if constexpr (!is_reflected<Member>::value) {
+                if (!done && f.hash == hash && f.name == key) {
+                    decode_scalar(target.*(f.member), kind, raw, key);
+                    done = true;
+                }
+            }
+        };
+        (visit(field), ...);
+    }, fields_of<T>());
+    // Unknown keys are ignored so older binaries accept newer files
+}
+
+template <typename T>
+BindFrame child_frame(void* object, std::string_view name) {
+    T& target = *static_cast<T*>(object);
+    const std::uint64_t hash = key_hash(name);
+    BindFrame frame;
+    std::apply([&](const auto&... field) {
+        auto visit = [&](const auto& f) {
+            using Member = std::remove_reference_t<decltype(target.*(f.member))>;
+            if constexpr (is_reflected<Member>::value) {
+                if (!frame.object && f.hash == hash && f.name == name) frame = bind_frame(target.*(f.member));
+            }
+        };
+        (visit(field), ...);
+    }, fields_of<T>());
+    return frame;
+}
+
+template <typename T>
+BindFrame bind_frame(T& object) {
+    return BindFrame{&object, &assign_field<T>, &child_frame<T>};
+}
+
+// Visitor that routes events into a reflected struct; sections without a
+// matching member are skipped along with everything below them
+class Binder : public Visitor {
+private:
+    std::vector<BindFrame> frames_;
+
+public:
+    explicit Binder(BindFrame root) : frames_{root} {}
+
+    void on_section_enter(Span<const std::string_view> path, int /*depth*/) {
+        const BindFrame& parent = frames_.back();
+        frames_.push_back(parent.object ? parent.child(parent.object, path[path.size() - 1]) : BindFrame{});
+    }
+
+    void on_value(std::string_view key, TokenKind kind, std::string_view raw) {
+        const BindFrame& frame = frames_.back();
+        if (frame.object) frame.assign(frame.object, key, kind, raw);
+    }
+
+    void on_section_exit(Span<const std::string_view> /*path*/, int /*depth*/) {
+        frames_.pop_back();
+    }
+};
+
+template <typename T>
+void encode_struct(const T& object, Writer& writer, int depth) {
+    constexpr auto fields = fields_of<T>();
+    // Values first, then subsections, as Writer::write() lays them out
+    std::apply([&](const auto&... field) {
+        auto visit = [&](const auto& f) {
+            using Member = std::remove_reference_t<decltype(object.*(f.member))>;
+            if constexpr (!is_reflected<std::remove_const_t<Member>>::value) {
+                writer.write_entry(f.name, object.*(f.member), depth);
+            }
+        };
+        (visit(field), ...);
+    }, fields);
+    std::apply([&](const auto&... field) {
+        auto visit = [&](const auto& f) {
+            using Member = std::remove_reference_t<decltype(object.*(f.member))>;
+            if constexpr (is_reflected<std::remove_const_t<Member>>::value) {
+                writer.write_header(f.name, depth + 1);
+                encode_struct(object.*(f.member), writer, depth + 1);
+            }
+        };
+        (visit(field), ...);
+    }, fields);
+}
+
+} // namespace detail
+
+// Fill a reflected struct from YINI text. Members without a matching key
+// keep their current values; unknown keys and sections are ignored. Type
+// mismatches throw ParseError with the line number.
+template <typename T>
+void decode(std::string_view content, T& out) {
+    static_assert(detail::is_reflected<T>::value, "type needs YINI_REFLECT");
+    detail::Binder binder(detail::bind_frame(out));
+    sax_parse(content, binder);
+}
+
+template <typename T>
+T decode(std::string_view content) {
+    T out{};
+    decode(content, out);
+    return out;
+}
+
+template <typename T>
+void decode_file(const std::string& filename, T& out) {
+    detail::FileSource source(filename);
+    if (source.mapped()) {
+        decode(source.view(), out);
+    } else {
+        std::string content = source.read_all();
+        decode(std::string_view(content), out);
+    }
+}
+
+// Serialize a reflected struct without building a Section tree
+template <typename T>
+void encode(const T& value, Writer& writer) {
+    static_assert(detail::is_reflected<T>::value, "type needs YINI_REFLECT");
+    detail::encode_struct(value, writer, 0);
+    writer.flush();
+}
+
+template <typename T>
+std::string encode(const T& value) {
+    Writer writer;
+    encode(value, writer);
+    return writer.take();
+}
+
+class Document;
+
+// Value stored inside a Document, packed into 16 bytes: the last byte holds
+// the kind, strings of up to 14 bytes are stored inline, and longer strings
+// and arrays point into the document arena. A DocValue holding a long
+// string or an array is only valid while its Document is alive.
+class DocValue {
+public:
+    static constexpr size_t inline_capacity = 14;
+
+private:
+    friend class Document;
+
+    static constexpr unsigned char inline_flag = 0x80;
+    static constexpr size_t size_offset = sizeof(const void*);
+    static constexpr size_t length_byte = 14;
+    static constexpr size_t tag_byte = 15;
+
+    alignas(8) unsigned char bytes_[16] = {};
+
+    template <typename T>
+    T load(size_t offset = 0) const {
+        T result;
+        std::memcpy(&result, bytes_ + offset, sizeof(T));
+        return result;
+    }
+
+    template <typename T>
+    void store(const T& value, size_t offset = 0) {
+        std::memcpy(bytes_ + offset, &value, sizeof(T));
+    }
+
+    void set_tag(TokenKind kind, bool inline_string = false) {
+        bytes_[tag_byte] = static_cast<unsigned char>(kind) | (inline_string ? inline_flag : 0);
+    }
+
+    bool is_inline() const { return (bytes_[tag_byte] & inline_flag) != 0; }
+
+    void store_ref(const void* data, size_t size) {
+        if (size > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("Value too large for a document");
+        }
+        store(data);
+        store(static_cast<std::uint32_t>(size), size_offset);
+    }
+
+    static DocValue make_int(std::int64_t value) {
+        DocValue result;
+        result.store(value);
+        result.set_tag(TokenKind::Int);
+        return result;
+    }
+
+    static DocValue make_double(double value) {
+        DocValue result;
+        result.store(value);
+        result.set_tag(TokenKind::Double);
+        return result;
+    }
+
+    static DocValue make_bool(bool value) {
+        DocValue result;
+        result.bytes_[0] = value ? 1 : 0;
+        result.set_tag(TokenKind::Bool);
+        return result;
+    }
+
+    // Short strings are copied inline; longer ones must already live in the arena
+    static DocValue make_string(std::string_view text) {
+        DocValue result;
+        if (text.size() <= inline_capacity) {
+            std::memcpy(result.bytes_, text.data(), text.size());
+            result.bytes_[length_byte] = static_cast<unsigned char>(text.size());
+            result.set_tag(TokenKind::String, true);
+        } else {
+            result.store_ref(text.data(), text.size());
+            result.set_tag(TokenKind::String);
+        }
+        return result;
+    }
+
+    static DocValue make_array(const DocValue* items, size_t count) {
+        DocValue result;
+        result.store_ref(items, count);
+        result.set_tag(TokenKind::Array);
+        return result;
+    }
+
+public:
+    DocValue() { set_tag(TokenKind::String, true); }
+
+    TokenKind kind() const { return static_cast<TokenKind>(bytes_[tag_byte] & ~inline_flag); }
+    bool is_string() const { return kind() == TokenKind::String; }
+    bool is_int() const { return kind() == TokenKind::Int; }
+    bool is_double() const { return kind() == TokenKind::Double; }
+    bool is_bool() const { return kind() == TokenKind::Bool; }
+    bool is_array() const { return kind() == TokenKind::Array; }
+
+    std::string_view as_string() const {
+        if (!is_string()) throw std::runtime_error("Value is not a string");
+        if (is_inline()) {
+            return std::string_view(reinterpret_cast<const char*>(bytes_), bytes_[length_byte]);
+        }
+        return std::string_view(load<const char*>(), load<std::uint32_t>(size_offset));
+    }
+
+    int as_int() const {
+        if (is_int()) {
+            std::int64_t value = load<std::int64_t>();
+            if (value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max()) {
+                throw std::out_of_range("Integer value out of int range");
+            }
+            return static_cast<int>(value);
+        }
+        if (is_double()) return static_cast<int>(load<double>());
+        if (is_string()) {
+            int result = 0;
+            if (detail::parse_int(detail::trim(as_string()), result)) return result;
+            throw std::runtime_error("Cannot convert string to int");
+        }
+        throw std::runtime_error("Cannot convert to int");
+    }
+
+    std::int64_t as_int64() const {
+        if (is_int()) return load<std::int64_t>();
+        if (is_double()) return static_cast<std::int64_t>(load<double>());
+        if (is_string()) {
+            std::int64_t result = 0;
+            if (detail::parse_int(detail::trim(as_string()), result)) return result;
+            throw std::runtime_error("Cannot convert string to int");
+        }
+        throw std::runtime_error("Cannot convert to int");
+    }
+
+    double as_double() const {
+        if (is_double()) return load<double>();
+        if (is_int()) return static_cast<double>(load<std::int64_t>());
+        if (is_string()) {
+            double result = 0.0;
+            if (detail::parse_double(detail::trim(as_string()), result)) return result;
+            throw std::runtime_error("Cannot convert string to double");
+        }
+        throw std::runtime_error("Cannot convert to double");
+    }
+
+    bool as_bool() const {
+        if (is_bool()) return bytes_[0] != 0;
+        if (is_int()) return load<std::int64_t>() != 0;
+        if (is_string()) {
+            std::string_view str = as_string();
+            return detail::iequals(str, "true") || detail::iequals(str, "yes") ||
+                   detail::iequals(str, "on") || str == "1";
+        }
+        throw std::runtime_error("Cannot convert to bool");
+    }
+
+    Span<const DocValue> as_array() const {
+        if (!is_array()) throw std::runtime_error("Value is not an array");
+        return Span<const DocValue>(load<const DocValue*>(), load<std::uint32_t>(size_offset));
+    }
+
+    // Copy into a standalone Value
+    Value to_value() const {
+        switch (kind()) {
+            case TokenKind::Int: return Value(load<std::int64_t>());
+            case TokenKind::Double: return Value(load<double>());
+            case TokenKind::Bool: return Value(bytes_[0] != 0);
+            case TokenKind::Array: {
+                std::vector<Value> array;
+                Span<const DocValue> items = as_array();
+                array.reserve(items.size());
+                for (const DocValue& item : items) array.push_back(item.to_value());
+                return Value(std::move(array));
+            }
+            case TokenKind::String: break;
+        }
+        return Value(std::string(as_string()));
+    }
+};
+
+static_assert(sizeof(DocValue) == 16, "DocValue must stay 16 bytes");
+
+// Key/value pair inside a DocSection
+struct DocEntry {
+    std::string_view key;
+    DocValue value;
+};
+
+// Section of a Document. Entries keep source order; an index is only
+// built once a section grows past a handful of entries.
+class DocSection {
+private:
+    friend class Document;
+
+    static constexpr size_t index_threshold = 8;
+
+    using Index = std::pmr::unordered_map<std::string_view, size_t>;
+
+    std::string_view name_;
+    std::pmr::vector<DocEntry> values_;
+    std::pmr::vector<DocSection*> subsections_;
+    Index* value_index_ = nullptr;
+    Index* section_index_ = nullptr;
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    template <typename T, typename KeyOf>
+    static size_t lookup(const std::pmr::vector<T>& items, const Index* index,
+                         std::string_view key, KeyOf key_of) {
+        if (index) {
+            auto it = index->find(key);
+            return it == index->end() ? npos : it->second;
+        }
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (key_of(items[i]) == key) return i;
+        }
+        return npos;
+    }
+
+    template <typename T, typename KeyOf>
+    static void grow_index(const std::pmr::vector<T>& items, Index*& index, KeyOf key_of,
+                           std::pmr::memory_resource* arena) {
+        if (index) {
+            index->emplace(key_of(items.back()), items.size() - 1);
+            return;
+        }
+        if (items.size() <= index_threshold) return;
+        void* memory = arena->allocate(sizeof(Index), alignof(Index));
+        index = new (memory) Index(arena);
+        index->reserve(items.size() * 2);
+        for (size_t i = 0; i < items.size(); ++i) index->emplace(key_of(items[i]), i);
+    }
+
+    static std::string_view entry_key(const DocEntry& entry) { return entry.key; }
+    static std::string_view section_key(const DocSection* section) { return section->name_; }
+
+public:
+    DocSection(std::string_view name, std::pmr::memory_resource* arena)
+        : name_(name), values_(arena), subsections_(arena) {}
+
+    std::string_view name() const { return name_; }
+
+    // Value access
+    const DocValue* find(std::string_view key) const {
+        size_t index = lookup(values_, value_index_, key, entry_key);
+        return index == npos ? nullptr : &values_[index].value;
+    }
+
+    const DocValue& at(std::string_view key) const {
+        const DocValue* value = find(key);
+        if (!value) {
+            throw std::out_of_range("Key not found: " + std::string(key));
+        }
+        return *value;
+    }
+
+    bool has_value(std::string_view key) const { return find(key) != nullptr; }
+
+    // Section access
+    const DocSection* find_section(std::string_view name) const {
+        size_t index = lookup(subsections_, section_index_, name, section_key);
+        return index == npos ? nullptr : subsections_[index];
+    }
+
+    const DocSection& get_section(std::string_view name) const {
+        const DocSection* section = find_section(name);
+        if (!section) {
+            throw std::out_of_range("Section not found: " + std::string(name));
+        }
+        return *section;
+    }
+
+    bool has_section(std::string_view name) const { return find_section(name) != nullptr; }
+
+    // Iteration in source order
+    Span<const DocEntry> values() const { return Span<const DocEntry>(values_.data(), values_.size()); }
+    Span<DocSection* const> sections() const {
+        return Span<DocSection* const>(subsections_.data(), subsections_.size());
+    }
+};
+
+// Read-only document whose sections, keys, values and arrays all live in a
+// single monotonic arena. Destroying or re-parsing the document releases
+// everything at once instead of walking the tree.
+class Document {
+private:
+    std::pmr::monotonic_buffer_resource arena_;
+    DocSection* root_ = nullptr;
+
+    std::string_view copy_string(std::string_view text) {
+        if (text.empty()) return {};
+        char* data = static_cast<char*>(arena_.allocate(text.size(), 1));
+        std::copy(text.begin(), text.end(), data);
+        return std::string_view(data, text.size());
+    }
+
+    DocSection* new_section(std::string_view name) {
+        void* memory = arena_.allocate(sizeof(DocSection), alignof(DocSection));
+        return new (memory) DocSection(copy_string(name), &arena_);
+    }
+
+    DocSection* child(DocSection* parent, std::string_view name) {
+        size_t index = DocSection::lookup(parent->subsections_, parent->section_index_,
+                                          name, DocSection::section_key);
+        if (index != DocSection::npos) return parent->subsections_[index];
+
+        parent->subsections_.push_back(new_section(name));
+        DocSection::grow_index(parent->subsections_, parent->section_index_,
+                               DocSection::section_key, &arena_);
+        return parent->subsections_.back();
+    }
+
+    void set_value(DocSection* section, std::string_view key, const DocValue& value) {
+        size_t index = DocSection::lookup(section->values_, section->value_index_,
+                                          key, DocSection::entry_key);
+        if (index != DocSection::npos) {
+            section->values_[index].value = value;
+            return;
+        }
+
+        section->values_.push_back(DocEntry{copy_string(key), value});
+        DocSection::grow_index(section->values_, section->value_index_,
+                               DocSection::entry_key, &arena_);
+    }
+
+    DocValue make_value(TokenKind kind, std::string_view raw) {
+        switch (kind) {
+            case TokenKind::Bool: {
+                bool result = false;
+                detail::parse_bool(raw, result);
+                return DocValue::make_bool(result);
+            }
+            case TokenKind::Int: {
+                std::int64_t result = 0;
+                detail::parse_int(raw, result);
+                return DocValue::make_int(result);
+            }
+            case TokenKind::Double: {
+                double result = 0.0;
+                detail::parse_double(raw, result);
+                return DocValue::make_double(result);
+            }
+            case TokenKind::Array: {
+                // Reserve for every comma-separated slot; empty items are skipped
+                size_t capacity = raw.size() >= 2 ? detail::count_items(raw.substr(1, raw.size() - 2)) : 0;
+                void* memory = arena_.allocate(sizeof(DocValue) * capacity, alignof(DocValue));
+                DocValue* items = static_cast<DocValue*>(memory);
+                size_t count = 0;
+                for_each_element(raw, [&](TokenKind item_kind, std::string_view item) {
+                    new (&items[count++]) DocValue(make_value(item_kind, item));
+                });
+                return DocValue::make_array(items, count);
+            }
+            case TokenKind::String:
+                break;
+        }
+        return DocValue::make_string(raw.size() <= DocValue::inline_capacity ? raw : copy_string(raw));
+    }
+
+    // Visitor that fills the arena
+    class Builder : public Visitor {
+    private:
+        Document& document_;
+        std::vector<DocSection*> section_stack_;
+
+    public:
+        explicit Builder(Document& document) : document_(document), section_stack_{document.root_} {}
+
+        void on_section_enter(Span<const std::string_view> path, int /*depth*/) {
+            section_stack_.push_back(document_.child(section_stack_.back(), path[path.size() - 1]));
+        }
+
+        void on_value(std::string_view key, TokenKind kind, std::string_view raw) {
+            document_.set_value(section_stack_.back(), key, document_.make_value(kind, raw));
+        }
+
+        void on_section_exit(Span<const std::string_view> /*path*/, int /*depth*/) {
+            section_stack_.pop_back();
+        }
+    };
+
+public:
+    explicit Document(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : arena_(upstream) {
+        root_ = new_section({});
+    }
+
+    Document(const Document&) = delete;
+    Document& operator=(const Document&) = delete;
+
+    // Parse from a view; the input does not need to outlive the document
+    void parse(std::string_view content) {
+        clear();
+
+        Builder builder(*this);
+        sax_parse(content, builder);
+    }
+
+    void parse_file(const std::string& filename) {
+        detail::FileSource source(filename);
+        if (source.mapped()) {
+            parse(source.view());
+        } else {
+            parse(source.read_all());
+        }
+    }
+
+    // Release every allocation in one go
+    void clear() {
+        arena_.release();
+        root_ = new_section({});
+    }
+
+    const DocSection& root() const { return *root_; }
 };
 
 } // namespace yini
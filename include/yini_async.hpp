@@ -0,0 +1,329 @@
+#ifndef YINI_ASYNC_HPP
+#define YINI_ASYNC_HPP
+
+#include "yini.hpp"
+
+// Coroutine file I/O over io_uring. Needs C++20 coroutines and liburing
+// (link with -luring); without them this header declares nothing and
+// YINI_ASYNC_AVAILABLE stays undefined.
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>) && __has_include(<liburing.h>)
+#define YINI_ASYNC_AVAILABLE 1
+
+#include <algorithm>
+#include <cerrno>
+#include <coroutine>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <liburing.h>
+
+namespace yini {
+
+// Every SQE submitted here carries a pointer to a UringOperation as its
+// user_data. An application with its own event loop passes those CQEs to
+// UringOperation::dispatch(); run_until() and sync_wait() do it for
+// programs without one.
+struct UringOperation {
+    std::coroutine_handle<> waiter;
+    int result = 0;
+
+    // Marks the CQE seen and resumes the coroutine waiting on it. The
+    // operation lives in that coroutine's frame, so dispatching a CQE
+    // whose task was destroyed before it finished is a use after free;
+    // see Task.
+    static void dispatch(io_uring& ring, io_uring_cqe* cqe) {
+        auto* operation = static_cast<UringOperation*>(io_uring_cqe_get_data(cqe));
+        int result = cqe->res;
+        io_uring_cqe_seen(&ring, cqe);
+        if (!operation) return;
+        operation->result = result;
+        operation->waiter.resume();
+    }
+};
+
+namespace detail {
+
+// Awaits one submission; prep fills in the SQE. The result is the CQE's
+// res field (a negative errno on failure).
+template <typename Prep>
+class UringAwaiter {
+private:
+    io_uring& ring_;
+    Prep prep_;
+    UringOperation operation_;
+
+public:
+    UringAwaiter(io_uring& ring, Prep prep) : ring_(ring), prep_(std::move(prep)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> waiter) {
+        io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+        if (!sqe) {
+            // Queue full: flush it and retry once
+            io_uring_submit(&ring_);
+            sqe = io_uring_get_sqe(&ring_);
+            if (!sqe) throw FileError("io_uring submission queue is full");
+        }
+        prep_(sqe);
+        operation_.waiter = waiter;
+        io_uring_sqe_set_data(sqe, &operation_);
+        io_uring_submit(&ring_);
+    }
+
+    int await_resume() const noexcept { return operation_.result; }
+};
+
+template <typename Prep>
+UringAwaiter<Prep> uring_op(io_uring& ring, Prep prep) {
+    return UringAwaiter<Prep>(ring, std::move(prep));
+}
+
+template <typename T>
+struct TaskResult {
+    std::optional<T> value;
+
+    void return_value(T result) { value = std::move(result); }
+    T take() { return std::move(*value); }
+};
+
+template <>
+struct TaskResult<void> {
+    void return_void() {}
+    void take() {}
+};
+
+} // namespace detail
+
+// Lazily started coroutine. co_await it from another coroutine, or call
+// start() and poll done() from a loop that dispatches completions.
+//
+// A started task must be driven to done() before it is destroyed. While
+// it is suspended on an I/O operation the kernel still holds a pointer
+// into its frame, and outstanding operations are not cancelled; the
+// completion would resume freed memory. An unstarted task may be
+// destroyed at any time.
+template <typename T>
+class Task {
+public:
+    struct promise_type : detail::TaskResult<T> {
+        std::exception_ptr error;
+        std::coroutine_handle<> continuation;
+        bool started = false;
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        auto final_suspend() noexcept {
+            struct Resume {
+                bool await_ready() const noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> self) noexcept {
+                    std::coroutine_handle<> next = self.promise().continuation;
+                    return next ? next : std::noop_coroutine();
+                }
+                void await_resume() const noexcept {}
+            };
+            return Resume{};
+        }
+
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+public:
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    // Same precondition as the destructor for the task being replaced
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    // Precondition: the task was never started, or done() is true
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+    // Run until the first suspension; a started task can still be awaited
+    void start() {
+        handle_.promise().started = true;
+        handle_.resume();
+    }
+    bool done() const { return handle_.done(); }
+
+    // Result of a finished task; rethrows its exception
+    T get() {
+        if (handle_.promise().error) std::rethrow_exception(handle_.promise().error);
+        return handle_.promise().take();
+    }
+
+    bool await_ready() const noexcept { return handle_.done(); }
+
+    // A task that is already running resumes the waiter when it finishes
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> waiter) noexcept {
+        promise_type& promise = handle_.promise();
+        promise.continuation = waiter;
+        if (promise.started) return std::noop_coroutine();
+        promise.started = true;
+        return handle_;
+    }
+
+    T await_resume() { return get(); }
+};
+
+// Waits for completions on ring and dispatches them until done() is true
+template <typename Done>
+void run_until(io_uring& ring, Done done) {
+    while (!done()) {
+        io_uring_cqe* cqe = nullptr;
+        int status = io_uring_wait_cqe(&ring, &cqe);
+        if (status == -EINTR) continue;
+        if (status < 0) throw FileError("io_uring wait failed: " + std::string(std::strerror(-status)));
+        UringOperation::dispatch(ring, cqe);
+    }
+}
+
+// Drive a single task to completion on the calling thread
+template <typename T>
+T sync_wait(io_uring& ring, Task<T> task) {
+    task.start();
+    run_until(ring, [&]() { return task.done(); });
+    return task.get();
+}
+
+namespace detail {
+
+inline Task<int> uring_close(io_uring& ring, int fd) {
+    co_return co_await uring_op(ring, [fd](io_uring_sqe* sqe) { io_uring_prep_close(sqe, fd); });
+}
+
+// Waits until fd is ready for events instead of resubmitting a read or
+// write that returned -EAGAIN straight away
+inline Task<int> uring_poll(io_uring& ring, int fd, unsigned events) {
+    co_return co_await uring_op(ring, [fd, events](io_uring_sqe* sqe) { io_uring_prep_poll_add(sqe, fd, events); });
+}
+
+// Offset for reads: explicit for regular files, and -1 (the current file
+// position) for pipes, FIFOs and other non-seekable files, which reject an
+// explicit offset with -ESPIPE
+inline bool seekable(int fd) {
+    struct stat info {};
+    return ::fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+}
+
+constexpr std::uint64_t current_position = static_cast<std::uint64_t>(-1);
+
+} // namespace detail
+
+// Open, read and parse a file without blocking the calling thread. Chunks
+// go straight into the push parser, so only one chunk and the partial
+// line are buffered.
+inline Task<Parser> async_parse_file(io_uring& ring, std::string filename,
+                                     size_t chunk_size = detail::FileSource::chunk_size) {
+    int fd = co_await detail::uring_op(ring, [&filename](io_uring_sqe* sqe) {
+        io_uring_prep_openat(sqe, AT_FDCWD, filename.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    });
+    if (fd < 0) throw FileError("Cannot open file: " + filename);
+
+    Parser parser;
+    std::vector<char> chunk(chunk_size);
+    std::exception_ptr error;
+    try {
+        bool positioned = detail::seekable(fd);
+        std::uint64_t offset = 0;
+        while (true) {
+            int got = co_await detail::uring_op(ring, [&](io_uring_sqe* sqe) {
+                io_uring_prep_read(sqe, fd, chunk.data(), static_cast<unsigned>(chunk.size()),
+                                   positioned ? offset : detail::current_position);
+            });
+            if (got == -EINTR) continue;
+            if (got == -EAGAIN) {
+                co_await detail::uring_poll(ring, fd, POLLIN);
+                continue;
+            }
+            if (got < 0) throw FileError("Cannot read file: " + filename);
+            if (got == 0) break;
+            parser.feed(chunk.data(), static_cast<size_t>(got));
+            offset += static_cast<std::uint64_t>(got);
+        }
+        parser.finish();
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    co_await detail::uring_close(ring, fd);
+    if (error) std::rethrow_exception(error);
+    co_return parser;
+}
+
+// Write text to a file without blocking, replacing its contents. Like
+// Parser::write_file(), the text goes to a temporary next to the file that
+// is renamed over it once complete, so a failed write leaves the old file
+// intact. Needs Linux 5.11 or later for IORING_OP_RENAMEAT.
+inline Task<void> async_write_file(io_uring& ring, std::string filename, std::string content) {
+    std::string temporary;
+    int fd = -EEXIST;
+    for (int attempt = 0; attempt < 100 && fd == -EEXIST; ++attempt) {
+        temporary = detail::temporary_name(filename);
+        fd = co_await detail::uring_op(ring, [&temporary](io_uring_sqe* sqe) {
+            io_uring_prep_openat(sqe, AT_FDCWD, temporary.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        });
+    }
+    if (fd < 0) throw FileError("Cannot write to file: " + filename);
+
+    bool failed = false;
+    size_t written = 0;
+    while (written < content.size()) {
+        int put = co_await detail::uring_op(ring, [&](io_uring_sqe* sqe) {
+            size_t size = std::min<size_t>(content.size() - written, 1u << 30);
+            io_uring_prep_write(sqe, fd, content.data() + written, static_cast<unsigned>(size), written);
+        });
+        if (put == -EINTR) continue;
+        if (put == -EAGAIN) {
+            co_await detail::uring_poll(ring, fd, POLLOUT);
+            continue;
+        }
+        if (put <= 0) {
+            failed = true;
+            break;
+        }
+        written += static_cast<size_t>(put);
+    }
+
+    int closed = co_await detail::uring_close(ring, fd);
+    if (!failed && closed >= 0) {
+        int renamed = co_await detail::uring_op(ring, [&](io_uring_sqe* sqe) {
+            io_uring_prep_renameat(sqe, AT_FDCWD, temporary.c_str(), AT_FDCWD, filename.c_str(), 0);
+        });
+        if (renamed >= 0) co_return;
+    }
+    co_await detail::uring_op(ring, [&temporary](io_uring_sqe* sqe) {
+        io_uring_prep_unlinkat(sqe, AT_FDCWD, temporary.c_str(), 0);
+    });
+    throw FileError("Cannot write to file: " + filename);
+}
+
+// Serializes parser now, so it may change or go away while the write runs
+inline Task<void> async_write_file(io_uring& ring, std::string filename, const Parser& parser) {
+    return async_write_file(ring, std::move(filename), parser.write_string());
+}
+
+} // namespace yini
+
+#endif
+
+#endif // YINI_ASYNC_HPP
@@ -0,0 +1,483 @@
+#ifndef YINI_WATCH_HPP
+#define YINI_WATCH_HPP
+
+#include "yini.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#if defined(_WIN32)
+// <windows.h> is already included by yini.hpp
+#elif defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#define YINI_WATCH_INOTIFY 1
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+#include <sys/event.h>
+#include <sys/time.h>
+#define YINI_WATCH_KQUEUE 1
+#endif
+
+namespace yini {
+
+// One entry of a structural diff between two trees
+struct Change {
+    enum class Kind { Added, Removed, Changed };
+
+    Kind kind = Kind::Changed;
+    std::string section;  // Dotted section path, empty for the root
+    std::string key;
+};
+
+using Diff = std::vector<Change>;
+
+namespace detail {
+
+inline std::string join_path(const std::string& parent, const std::string& name) {
+    return parent.empty() ? name : parent + "." + name;
+}
+
+// Reports every key below section as added or removed
+inline void report_all(const Section& section, const std::string& path, Change::Kind kind, Diff& out) {
+    for (auto it = section.values_begin(); it != section.values_end(); ++it) {
+        out.push_back(Change{kind, path, it->first});
+    }
+    for (auto it = section.sections_begin(); it != section.sections_end(); ++it) {
+        report_all(*it->second, join_path(path, it->first), kind, out);
+    }
+}
+
+inline void diff_into(const Section& before, const Section& after, const std::string& path, Diff& out) {
+    // Shared subtrees are unchanged by construction
+    if (&before == &after) return;
+
+    for (auto it = before.values_begin(); it != before.values_end(); ++it) {
+        if (!after.has_value(it->first)) {
+            out.push_back(Change{Change::Kind::Removed, path, it->first});
+        } else if (after.at(it->first) != it->second) {
+            out.push_back(Change{Change::Kind::Changed, path, it->first});
+        }
+    }
+    for (auto it = after.values_begin(); it != after.values_end(); ++it) {
+        if (!before.has_value(it->first)) {
+            out.push_back(Change{Change::Kind::Added, path, it->first});
+        }
+    }
+
+    for (auto it = before.sections_begin(); it != before.sections_end(); ++it) {
+        const Section* now = after.find_section(it->first);
+        if (now) {
+            diff_into(*it->second, *now, join_path(path, it->first), out);
+        } else {
+            report_all(*it->second, join_path(path, it->first), Change::Kind::Removed, out);
+        }
+    }
+    for (auto it = after.sections_begin(); it != after.sections_end(); ++it) {
+        if (!before.has_section(it->first)) {
+            report_all(*it->second, join_path(path, it->first), Change::Kind::Added, out);
+        }
+    }
+}
+
+// Blocks until the watched file may have changed. Spurious wake-ups are
+// fine: the watcher compares content hashes before reparsing.
+class FileEvents {
+private:
+    std::string filename_;
+
+#if defined(YINI_WATCH_INOTIFY)
+    int inotify_ = -1;
+    int wake_[2] = {-1, -1};
+    std::string basename_;
+
+public:
+    explicit FileEvents(const std::string& filename) : filename_(filename) {
+        size_t slash = filename.rfind('/');
+        std::string directory = slash == std::string::npos ? "." : filename.substr(0, slash + 1);
+        basename_ = slash == std::string::npos ? filename : filename.substr(slash + 1);
+
+        inotify_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotify_ < 0 || ::pipe2(wake_, O_NONBLOCK | O_CLOEXEC) != 0) {
+            close_all();
+            throw FileError("Cannot watch file: " + filename_);
+        }
+        // Watch the directory so replacing the file by rename is seen
+        if (::inotify_add_watch(inotify_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            close_all();
+            throw FileError("Cannot watch file: " + filename_);
+        }
+    }
+
+    ~FileEvents() { close_all(); }
+
+    // Returns false once interrupt() has been called
+    bool wait() {
+        alignas(struct inotify_event) char buffer[4096];
+        while (true) {
+            pollfd fds[2] = {{inotify_, POLLIN, 0}, {wake_[0], POLLIN, 0}};
+            if (::poll(fds, 2, -1) < 0) {
+                if (errno == EINTR) continue;
+                throw FileError("Cannot watch file: " + filename_);
+            }
+            if (fds[1].revents != 0) return false;
+
+            bool matched = false;
+            ssize_t got;
+            while ((got = ::read(inotify_, buffer, sizeof(buffer))) > 0) {
+                for (char* cursor = buffer; cursor < buffer + got;) {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(cursor);
+                    if (event->len > 0 && basename_ == event->name) matched = true;
+                    cursor += sizeof(inotify_event) + event->len;
+                }
+            }
+            if (matched) return true;
+        }
+    }
+
+    void interrupt() {
+        char byte = 1;
+        ssize_t ignored = ::write(wake_[1], &byte, 1);
+        (void)ignored;
+    }
+
+private:
+    void close_all() {
+        if (inotify_ >= 0) ::close(inotify_);
+        if (wake_[0] >= 0) ::close(wake_[0]);
+        if (wake_[1] >= 0) ::close(wake_[1]);
+        inotify_ = wake_[0] = wake_[1] = -1;
+    }
+
+#elif defined(YINI_WATCH_KQUEUE)
+    int queue_ = -1;
+    int file_ = -1;
+    int wake_[2] = {-1, -1};
+
+    // (Re)registers the file itself; editors that replace it by rename
+    // leave the old vnode behind
+    bool watch_file() {
+        if (file_ >= 0) ::close(file_);
+#if defined(O_EVTONLY)
+        file_ = ::open(filename_.c_str(), O_EVTONLY | O_CLOEXEC);
+#else
+        file_ = ::open(filename_.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+        if (file_ < 0) return false;
+
+        struct kevent change;
+        EV_SET(&change, file_, EVFILT_VNODE, EV_ADD | EV_CLEAR,
+               NOTE_WRITE | NOTE_EXTEND | NOTE_DELETE | NOTE_RENAME | NOTE_ATTRIB, 0, nullptr);
+        return ::kevent(queue_, &change, 1, nullptr, 0, nullptr) == 0;
+    }
+
+public:
+    explicit FileEvents(const std::string& filename) : filename_(filename) {
+        queue_ = ::kqueue();
+        if (queue_ < 0 || ::pipe(wake_) != 0) {
+            close_all();
+            throw FileError("Cannot watch file: " + filename_);
+        }
+        struct kevent change;
+        EV_SET(&change, wake_[0], EVFILT_READ, EV_ADD, 0, 0, nullptr);
+        if (::kevent(queue_, &change, 1, nullptr, 0, nullptr) != 0 || !watch_file()) {
+            close_all();
+            throw FileError("Cannot watch file: " + filename_);
+        }
+    }
+
+    ~FileEvents() { close_all(); }
+
+    bool wait() {
+        while (true) {
+            // Poll while the file is missing between a delete and a re-create
+            timespec retry{0, 100 * 1000 * 1000};
+            struct kevent event;
+            int got = ::kevent(queue_, nullptr, 0, &event, 1, file_ < 0 ? &retry : nullptr);
+            if (got < 0) {
+                if (errno == EINTR) continue;
+                throw FileError("Cannot watch file: " + filename_);
+            }
+            if (got == 0) {
+                if (watch_file()) return true;
+                continue;
+            }
+            if (event.filter == EVFILT_READ) return false;
+
+            if ((event.fflags & (NOTE_DELETE | NOTE_RENAME)) && !watch_file()) {
+                if (file_ >= 0) ::close(file_);
+                file_ = -1;
+                continue;
+            }
+            return true;
+        }
+    }
+
+    void interrupt() {
+        char byte = 1;
+        ssize_t ignored = ::write(wake_[1], &byte, 1);
+        (void)ignored;
+    }
+
+private:
+    void close_all() {
+        if (queue_ >= 0) ::close(queue_);
+        if (file_ >= 0) ::close(file_);
+        if (wake_[0] >= 0) ::close(wake_[0]);
+        if (wake_[1] >= 0) ::close(wake_[1]);
+        queue_ = file_ = wake_[0] = wake_[1] = -1;
+    }
+
+#elif defined(_WIN32)
+    HANDLE change_ = INVALID_HANDLE_VALUE;
+    HANDLE stop_ = nullptr;
+
+public:
+    explicit FileEvents(const std::string& filename) : filename_(filename) {
+        size_t slash = filename.find_last_of("/\\");
+        std::string directory = slash == std::string::npos ? "." : filename.substr(0, slash + 1);
+
+        change_ = FindFirstChangeNotificationA(directory.c_str(), FALSE,
+                                               FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+        stop_ = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        if (change_ == INVALID_HANDLE_VALUE || !stop_) {
+            close_all();
+            throw FileError("Cannot watch file: " + filename_);
+        }
+    }
+
+    ~FileEvents() { close_all(); }
+
+    bool wait() {
+        HANDLE handles[2] = {stop_, change_};
+        DWORD result = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+        if (result == WAIT_OBJECT_0) return false;
+        if (result != WAIT_OBJECT_0 + 1 || !FindNextChangeNotification(change_)) {
+            throw FileError("Cannot watch file: " + filename_);
+        }
+        return true;
+    }
+
+    void interrupt() { SetEvent(stop_); }
+
+private:
+    void close_all() {
+        if (change_ != INVALID_HANDLE_VALUE) FindCloseChangeNotification(change_);
+        if (stop_) CloseHandle(stop_);
+        change_ = INVALID_HANDLE_VALUE;
+        stop_ = nullptr;
+    }
+
+#else
+    // No change notification API: poll every 250 ms
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopped_ = false;
+
+public:
+    explicit FileEvents(const std::string& filename) : filename_(filename) {}
+
+    bool wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return !wake_.wait_for(lock, std::chrono::milliseconds(250), [this] { return stopped_; });
+    }
+
+    void interrupt() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+        wake_.notify_all();
+    }
+#endif
+
+public:
+    FileEvents(const FileEvents&) = delete;
+    FileEvents& operator=(const FileEvents&) = delete;
+};
+
+} // namespace detail
+
+// Structural diff between two trees: keys added, removed or changed, each
+// with the dotted path of its section
+inline Diff diff(const Section& before, const Section& after) {
+    Diff out;
+    detail::diff_into(before, after, std::string(), out);
+    return out;
+}
+
+// Keeps a parsed file up to date. Each reload splits the text at top-level
+// "^" headers, reparses only the pieces whose bytes changed and reuses the
+// subtrees of the others, then publishes the new tree with an atomic
+// shared_ptr store. Readers take a snapshot with current() and are never
+// blocked; published trees must be treated as read-only.
+class Watcher {
+public:
+    using Callback = std::function<void(const std::shared_ptr<const Section>& tree, const Diff& diff)>;
+    using ErrorCallback = std::function<void(const std::exception& error)>;
+
+private:
+    // A top-level section as it last appeared in the file
+    struct Piece {
+        std::uint64_t hash = 0;
+        std::string text;
+        std::string name;
+        std::shared_ptr<const Section> tree;
+    };
+
+    std::string filename_;
+    std::shared_ptr<const Section> current_;
+    std::uint64_t content_hash_ = 0;
+    size_t content_size_ = 0;
+    bool loaded_ = false;
+    std::vector<Piece> pieces_;
+    std::atomic<size_t> reparsed_{0};
+    std::mutex update_mutex_;
+
+    std::unique_ptr<detail::FileEvents> events_;
+    std::thread thread_;
+
+    static void parse_into(std::string_view text, Section& target) {
+        detail::TreeBuilder builder(target);
+        sax_parse(text, builder);
+    }
+
+    void run(const Callback& on_change, const ErrorCallback& on_error) {
+        while (true) {
+            try {
+                if (!events_->wait()) return;
+                Diff changes;
+                if (reload(&changes) && on_change) on_change(current(), changes);
+            } catch (const std::exception& error) {
+                // The previous tree stays published
+                if (on_error) on_error(error);
+            }
+        }
+    }
+
+public:
+    // Loads the file once; throws FileError or ParseError if that fails
+    explicit Watcher(std::string filename) : filename_(std::move(filename)) {
+        reload();
+    }
+
+    ~Watcher() { stop(); }
+
+    Watcher(const Watcher&) = delete;
+    Watcher& operator=(const Watcher&) = delete;
+
+    const std::string& filename() const { return filename_; }
+
+    // Latest published tree; safe to call from any thread
+    std::shared_ptr<const Section> current() const { return std::atomic_load(&current_); }
+
+    // Number of top-level sections reparsed by the last update
+    size_t last_reparsed() const { return reparsed_; }
+
+    // Re-read the file now. Returns true, and publishes a new tree, when the
+    // contents changed; diff, when given, lists the changed keys and may be
+    // empty (a new empty section, reordered keys). On errors the published
+    // tree is left untouched.
+    bool reload(Diff* diff = nullptr) {
+        detail::FileSource source(filename_);
+        std::string content = source.read_all();
+        return update(content, diff);
+    }
+
+    // Apply new file contents
+    bool update(std::string_view content, Diff* diff = nullptr) {
+        std::lock_guard<std::mutex> lock(update_mutex_);
+        std::uint64_t content_hash = detail::hash_bytes(content);
+        if (loaded_ && content_hash == content_hash_ && content.size() == content_size_) {
+            if (diff) diff->clear();
+            return false;
+        }
+
+        std::vector<std::string_view> texts = detail::split_top_level(content, std::numeric_limits<size_t>::max());
+        std::unordered_map<std::uint64_t, const Piece*> previous;
+        previous.reserve(pieces_.size());
+        for (const Piece& piece : pieces_) previous.emplace(piece.hash, &piece);
+
+        auto root = std::make_shared<Section>();
+        std::vector<Piece> pieces;
+        pieces.reserve(texts.size());
+        size_t reparsed = 0;
+        try {
+            // The text before the first header holds root-level values
+            parse_into(texts[0], *root);
+
+            std::unordered_map<std::string_view, size_t> name_counts;
+            for (size_t i = 1; i < texts.size(); ++i) {
+                Piece piece;
+                piece.hash = detail::hash_bytes(texts[i]);
+                piece.text = std::string(texts[i]);
+
+                auto found = previous.find(piece.hash);
+                if (found != previous.end() && found->second->text == piece.text) {
+                    piece.name = found->second->name;
+                    piece.tree = found->second->tree;
+                } else {
+                    Section scratch;
+                    parse_into(texts[i], scratch);
+                    auto child = scratch.sections_begin();
+                    if (child != scratch.sections_end()) {
+                        piece.name = child->first;
+                        piece.tree = child->second;
+                    }
+                    ++reparsed;
+                }
+                pieces.push_back(std::move(piece));
+            }
+            for (const Piece& piece : pieces) ++name_counts[piece.name];
+
+            // Sections opened once are shared; reopened ones are rebuilt
+            for (const Piece& piece : pieces) {
+                if (piece.tree && name_counts[piece.name] == 1 && !root->has_section(piece.name)) {
+                    root->attach(piece.name, piece.tree);
+                } else {
+                    parse_into(piece.text, *root);
+                }
+            }
+        } catch (const ParseError&) {
+            // Line numbers inside a piece are relative; report against the file
+            Section full;
+            parse_into(content, full);
+            throw;
+        }
+
+        // Edits the diff cannot see still change the tree, so the diff is
+        // only for reporting
+        if (diff) {
+            std::shared_ptr<const Section> before = current();
+            *diff = before ? yini::diff(*before, *root) : Diff();
+        }
+
+        pieces_ = std::move(pieces);
+        content_hash_ = content_hash;
+        content_size_ = content.size();
+        loaded_ = true;
+        reparsed_.store(reparsed);
+        std::atomic_store(&current_, std::shared_ptr<const Section>(std::move(root)));
+        return true;
+    }
+
+    // Watch the file on a background thread. on_change runs on that thread
+    // after each update that changed the contents; on_error receives read and
+    // parse failures.
+    void start(Callback on_change, ErrorCallback on_error = {}) {
+        if (thread_.joinable()) return;
+        events_ = std::make_unique<detail::FileEvents>(filename_);
+        thread_ = std::thread([this, on_change = std::move(on_change), on_error = std::move(on_error)]() {
+            run(on_change, on_error);
+        });
+    }
+
+    void stop() {
+        if (!thread_.joinable()) return;
+        events_->interrupt();
+        thread_.join();
+        events_.reset();
+    }
+};
+
+} // namespace yini
+
+#endif // YINI_WATCH_HPP
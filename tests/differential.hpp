@@ -0,0 +1,267 @@
+#ifndef YINI_TESTS_DIFFERENTIAL_HPP
+#define YINI_TESTS_DIFFERENTIAL_HPP
+
+// Differential check shared by test_differential and the fuzz targets:
+// one input is parsed by Parser::parse_string and by every other path,
+// and all of them must accept or reject it together and build the same
+// tree.
+
+#include "yini.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace yini_check {
+
+// Empty when the trees match; otherwise the first difference
+inline std::string compare(const yini::Section& expected, const yini::Section& actual, const std::string& where = "") {
+    if (expected.value_count() != actual.value_count()) return where + ": value count differs";
+    if (expected.section_count() != actual.section_count()) return where + ": section count differs";
+
+    auto theirs = actual.values_begin();
+    for (auto ours = expected.values_begin(); ours != expected.values_end(); ++ours, ++theirs) {
+        if (ours->first != theirs->first) return where + ": key order differs at '" + ours->first + "'";
+        if (ours->second != theirs->second) return where + ": value differs for '" + ours->first + "'";
+    }
+    auto child = actual.sections_begin();
+    for (auto ours = expected.sections_begin(); ours != expected.sections_end(); ++ours, ++child) {
+        if (ours->first != child->first) return where + ": section order differs at '" + ours->first + "'";
+        std::string result = compare(*ours->second, *child->second, where + "/" + ours->first);
+        if (!result.empty()) return result;
+    }
+    return std::string();
+}
+
+inline std::string compare(const yini::Section& expected, const yini::FrozenSection& actual, const std::string& where) {
+    if (expected.value_count() != actual.keys().size()) return where + ": value count differs";
+    if (expected.section_count() != actual.section_names().size()) return where + ": section count differs";
+    for (auto it = expected.values_begin(); it != expected.values_end(); ++it) {
+        const yini::Value* value = actual.find(it->first);
+        if (!value || *value != it->second) return where + ": value differs for '" + it->first + "'";
+    }
+    for (auto it = expected.sections_begin(); it != expected.sections_end(); ++it) {
+        const yini::FrozenSection* section = actual.find_section(it->first);
+        if (!section) return where + ": missing section '" + it->first + "'";
+        std::string result = compare(*it->second, *section, where + "/" + it->first);
+        if (!result.empty()) return result;
+    }
+    return std::string();
+}
+
+inline std::string compare(const yini::Section& expected, const yini::DocSection& actual, const std::string& where) {
+    if (expected.value_count() != actual.values().size()) return where + ": value count differs";
+    if (expected.section_count() != actual.sections().size()) return where + ": section count differs";
+    size_t index = 0;
+    for (auto it = expected.values_begin(); it != expected.values_end(); ++it, ++index) {
+        const yini::DocEntry& entry = actual.values()[index];
+        if (entry.key != it->first) return where + ": key order differs at '" + it->first + "'";
+        if (entry.value.to_value() != it->second) return where + ": value differs for '" + it->first + "'";
+    }
+    index = 0;
+    for (auto it = expected.sections_begin(); it != expected.sections_end(); ++it, ++index) {
+        const yini::DocSection* section = actual.sections()[index];
+        if (section->name() != it->first) return where + ": section order differs at '" + it->first + "'";
+        std::string result = compare(*it->second, *section, where + "/" + it->first);
+        if (!result.empty()) return result;
+    }
+    return std::string();
+}
+
+// Strings the writer can emit verbatim: no quote, no comment opener and no
+// line break, which the format has no escapes for
+inline bool writable_text(std::string_view text) {
+    return text.find_first_of("'\"\n\r") == std::string_view::npos && text.find("//") == std::string_view::npos &&
+           text.find("/*") == std::string_view::npos;
+}
+
+inline bool writable(const yini::Value& value) {
+    if (const std::string* text = value.get_if<std::string>()) {
+        // Strings that read back as another type, or with edge spaces,
+        // are not distinguishable once written unquoted or trimmed
+        return writable_text(*text) && !text->empty() && yini::detail::trim(*text) == *text &&
+               text->find_first_of(",[]") == std::string::npos;
+    }
+    // The writer rejects inf and nan
+    if (const double* real = value.get_if<double>()) return std::isfinite(*real);
+    if (const yini::PackedArray* packed = value.get_if<yini::PackedArray>()) {
+        return std::all_of(packed->doubles().begin(), packed->doubles().end(), [](double real) { return std::isfinite(real); });
+    }
+    if (const std::vector<yini::Value>* items = value.get_if<std::vector<yini::Value>>()) {
+        for (const yini::Value& item : *items) {
+            if (!writable(item)) return false;
+        }
+    }
+    return true;
+}
+
+inline bool writable(const yini::Section& section) {
+    for (auto it = section.values_begin(); it != section.values_end(); ++it) {
+        if (!writable_text(it->first) || !writable(it->second)) return false;
+    }
+    for (auto it = section.sections_begin(); it != section.sections_end(); ++it) {
+        if (!writable_text(it->first) || !writable(*it->second)) return false;
+    }
+    return true;
+}
+
+inline bool has_nan(const yini::Section& section) {
+    for (auto it = section.values_begin(); it != section.values_end(); ++it) {
+        const yini::Value& value = it->second;
+        if (const double* real = value.get_if<double>()) {
+            if (*real != *real) return true;
+        } else if (value.is_array()) {
+            for (const yini::Value& item : value.array_ref()) {
+                const double* element = item.get_if<double>();
+                if (element && *element != *element) return true;
+            }
+        }
+    }
+    for (auto it = section.sections_begin(); it != section.sections_end(); ++it) {
+        if (has_nan(*it->second)) return true;
+    }
+    return false;
+}
+
+// Runs every path over input; returns the first mismatch, or an empty
+// string when all paths agree
+inline std::string check(std::string_view input) {
+    // Reference: the plain text parser
+    yini::Parser reference;
+    bool accepted = true;
+    try {
+        reference.parse_string(std::string(input));
+    } catch (const yini::ParseError&) {
+        accepted = false;
+    } catch (const std::exception& e) {
+        return std::string("reference: unexpected exception: ") + e.what();
+    }
+
+    // NaN values never compare equal, so only acceptance is compared
+    bool comparable = accepted && !has_nan(reference.root());
+
+    auto agree = [&](const char* path, auto&& run) -> std::string {
+        bool path_accepted = true;
+        std::string result;
+        try {
+            result = run();
+        } catch (const yini::ParseError&) {
+            path_accepted = false;
+        } catch (const std::exception& e) {
+            return std::string(path) + ": unexpected exception: " + e.what();
+        }
+        if (path_accepted != accepted) {
+            return std::string(path) + (accepted ? ": rejected valid input" : ": accepted invalid input");
+        }
+        return result.empty() ? result : std::string(path) + result;
+    };
+
+    std::string failure;
+
+    // Vectorised scanner against a byte loop
+    for (size_t from = 0; from < input.size(); from += 1 + input.size() / 16) {
+        size_t expected = from;
+        while (expected < input.size() && input[expected] != '\n' && input[expected] != '/') ++expected;
+        if (yini::detail::find_either(input.data(), from, input.size(), '\n', '/') != expected) {
+            return "scanner: wrong position from offset " + std::to_string(from);
+        }
+    }
+
+    // Push parsing in small, uneven chunks
+    failure = agree("push", [&]() {
+        yini::Parser pushed;
+        size_t step = 1;
+        for (size_t offset = 0; offset < input.size(); offset += step, step = step % 7 + 1) {
+            pushed.feed(input.data() + offset, std::min(step, input.size() - offset));
+        }
+        pushed.finish();
+        return comparable ? compare(reference.root(), pushed.root()) : std::string();
+    });
+    if (!failure.empty()) return failure;
+
+    // Pieces cut at top-level headers, parsed separately and merged as
+    // parse_parallel() does
+    failure = agree("split", [&]() {
+        yini::Section merged;
+        for (std::string_view piece : yini::detail::split_top_level(input, std::numeric_limits<size_t>::max())) {
+            yini::Section part;
+            yini::detail::TreeBuilder builder(part);
+            yini::sax_parse(piece, builder);
+            merged.merge(std::move(part));
+        }
+        return comparable ? compare(reference.root(), merged) : std::string();
+    });
+    if (!failure.empty()) return failure;
+
+    failure = agree("parallel", [&]() {
+        yini::Parser parallel;
+        parallel.parse_parallel(input, 2);
+        return comparable ? compare(reference.root(), parallel.root()) : std::string();
+    });
+    if (!failure.empty()) return failure;
+
+    // Lazy sections, every one materialised
+    failure = agree("lazy", [&]() {
+        yini::LazyDocument lazy;
+        lazy.parse(input);
+        for (std::string_view name : lazy.section_names()) lazy.get_section(name);
+        if (!comparable) return std::string();
+        // A header that does not start its line stays in the root piece
+        yini::Section rebuilt;
+        rebuilt.merge(lazy.root().clone());
+        for (std::string_view name : lazy.section_names()) {
+            rebuilt.section(name).merge(lazy.get_section(name).clone());
+        }
+        return compare(reference.root(), rebuilt);
+    });
+    if (!failure.empty()) return failure;
+
+    // Arena document
+    failure = agree("document", [&]() {
+        yini::Document document;
+        document.parse(input);
+        return comparable ? compare(reference.root(), document.root(), "") : std::string();
+    });
+    if (!failure.empty()) return failure;
+
+    if (!comparable) return std::string();
+
+    // Binary snapshot encode and decode
+    failure = agree("binary", [&]() {
+        yini::detail::binary::Encoder encoder;
+        std::string image = encoder.encode(reference.root(), 0);
+        yini::Section decoded;
+        yini::detail::binary::Decoder(image).decode_into(decoded);
+        return compare(reference.root(), decoded);
+    });
+    if (!failure.empty()) return failure;
+
+    failure = agree("frozen", [&]() { return compare(reference.root(), reference.freeze().root(), ""); });
+    if (!failure.empty()) return failure;
+
+    failure = agree("clone", [&]() {
+        yini::Parser copy = reference.clone();
+        return compare(reference.root(), copy.root());
+    });
+    if (!failure.empty()) return failure;
+
+    // Text round trip, for trees the format can spell
+    if (writable(reference.root())) {
+        failure = agree("write", [&]() {
+            std::string text = reference.write_string();
+            yini::Parser reparsed;
+            reparsed.parse_string(text);
+            std::string result = compare(reference.root(), reparsed.root());
+            if (result.empty() && reparsed.write_string() != text) result = ": output is not stable";
+            return result;
+        });
+        if (!failure.empty()) return failure;
+    }
+    return std::string();
+}
+
+} // namespace yini_check
+
+#endif // YINI_TESTS_DIFFERENTIAL_HPP
@@ -0,0 +1,42 @@
+#ifndef YINI_TEST_STUB_LIBURING_H
+#define YINI_TEST_STUB_LIBURING_H
+
+// Declarations of the liburing calls yini_async.hpp makes, with liburing's
+// signatures. Used only to compile-check the header where liburing is not
+// installed; nothing built against it is linked or run.
+
+#include <sys/types.h>
+
+struct io_uring_sqe;
+
+struct io_uring_cqe {
+    unsigned long long user_data;
+    int res;
+    unsigned flags;
+};
+
+struct io_uring {
+    unsigned flags;
+    int ring_fd;
+};
+
+int io_uring_queue_init(unsigned entries, struct io_uring* ring, unsigned flags);
+void io_uring_queue_exit(struct io_uring* ring);
+struct io_uring_sqe* io_uring_get_sqe(struct io_uring* ring);
+int io_uring_submit(struct io_uring* ring);
+int io_uring_wait_cqe(struct io_uring* ring, struct io_uring_cqe** cqe_ptr);
+void io_uring_cqe_seen(struct io_uring* ring, struct io_uring_cqe* cqe);
+void io_uring_sqe_set_data(struct io_uring_sqe* sqe, void* data);
+void* io_uring_cqe_get_data(const struct io_uring_cqe* cqe);
+
+void io_uring_prep_openat(struct io_uring_sqe* sqe, int dfd, const char* path, int flags, mode_t mode);
+void io_uring_prep_read(struct io_uring_sqe* sqe, int fd, void* buf, unsigned nbytes, unsigned long long offset);
+void io_uring_prep_write(struct io_uring_sqe* sqe, int fd, const void* buf, unsigned nbytes,
+                         unsigned long long offset);
+void io_uring_prep_close(struct io_uring_sqe* sqe, int fd);
+void io_uring_prep_poll_add(struct io_uring_sqe* sqe, int fd, unsigned poll_mask);
+void io_uring_prep_renameat(struct io_uring_sqe* sqe, int olddfd, const char* oldpath, int newdfd,
+                            const char* newpath, unsigned flags);
+void io_uring_prep_unlinkat(struct io_uring_sqe* sqe, int dfd, const char* path, int flags);
+
+#endif // YINI_TEST_STUB_LIBURING_H
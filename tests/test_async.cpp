@@ -0,0 +1,146 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <thread>
+#include <filesystem>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "yini_async.hpp"
+
+#if defined(YINI_ASYNC_REQUIRED) && !defined(YINI_ASYNC_AVAILABLE)
+#error "yini_async.hpp declared nothing; C++20 coroutines or <liburing.h> were not found"
+#endif
+
+#if defined(YINI_ASYNC_AVAILABLE)
+
+namespace {
+
+// Loads every file concurrently on one ring
+yini::Task<size_t> load_all(io_uring& ring, const std::vector<std::string>& files) {
+    std::vector<yini::Task<yini::Parser>> loads;
+    for (const std::string& file : files) {
+        loads.push_back(yini::async_parse_file(ring, file, 64));
+        loads.back().start();
+    }
+    size_t total = 0;
+    for (auto& load : loads) {
+        yini::Parser parser = co_await load;
+        total += static_cast<size_t>(parser["id"].as_int());
+    }
+    co_return total;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Running async tests..." << std::endl;
+
+    io_uring ring;
+    if (io_uring_queue_init(64, &ring, 0) < 0) {
+        std::cout << "io_uring is unavailable here; skipping" << std::endl;
+        std::cout << "All tests passed" << std::endl;
+        return 0;
+    }
+
+    try {
+        // Test 1: Write then parse a file
+        std::cout << "Testing async write and parse..." << std::endl;
+        yini::Parser source;
+        source.parse_file("example.yini");
+        yini::sync_wait(ring, yini::async_write_file(ring, "test_output_async.yini", source));
+
+        yini::Parser loaded = yini::sync_wait(ring, yini::async_parse_file(ring, "test_output_async.yini", 16));
+        assert(loaded.write_string() == source.write_string());
+        assert(loaded.section("server").section("connection")["host"].as_string() == "localhost");
+
+        // Test 2: Many loads in flight at once
+        std::cout << "Testing concurrent loads..." << std::endl;
+        std::vector<std::string> files;
+        size_t expected = 0;
+        for (int i = 0; i < 8; ++i) {
+            std::string file = "test_output_async_" + std::to_string(i) + ".yini";
+            yini::sync_wait(ring, yini::async_write_file(ring, file,
+                                                         "id = " + std::to_string(i) + "\n^ body\n    text = '" +
+                                                             std::string(200, 'x') + "'\n"));
+            files.push_back(file);
+            expected += static_cast<size_t>(i);
+        }
+        assert(yini::sync_wait(ring, load_all(ring, files)) == expected);
+        for (const std::string& file : files) std::remove(file.c_str());
+
+        // Test 3: Non-seekable files are read at the current position
+        std::cout << "Testing async FIFO reads..." << std::endl;
+        const char* fifo = "test_output_async.fifo";
+        std::remove(fifo);
+        assert(::mkfifo(fifo, 0600) == 0);
+        std::string piped = "id = 7\n^ body\n    text = '" + std::string(300, 'y') + "'\n";
+        std::thread producer([&]() {
+            std::FILE* out = std::fopen(fifo, "w");
+            if (!out) return;
+            std::fwrite(piped.data(), 1, piped.size(), out);
+            std::fclose(out);
+        });
+        yini::Parser from_fifo = yini::sync_wait(ring, yini::async_parse_file(ring, fifo, 64));
+        producer.join();
+        std::remove(fifo);
+        assert(from_fifo["id"].as_int() == 7);
+        assert(from_fifo.section("body")["text"].as_string() == std::string(300, 'y'));
+
+        // Test 4: Errors surface through co_await
+        std::cout << "Testing async errors..." << std::endl;
+        bool missing = false;
+        try {
+            yini::sync_wait(ring, yini::async_parse_file(ring, "does_not_exist.yini"));
+        } catch (const yini::FileError&) {
+            missing = true;
+        }
+        assert(missing);
+
+        yini::sync_wait(ring, yini::async_write_file(ring, "test_output_async.yini", std::string("a = 1\nbroken\n")));
+        bool malformed = false;
+        try {
+            yini::sync_wait(ring, yini::async_parse_file(ring, "test_output_async.yini"));
+        } catch (const yini::ParseError& e) {
+            malformed = std::string(e.what()).find("line 2") != std::string::npos;
+        }
+        assert(malformed);
+        std::remove("test_output_async.yini");
+
+        // A write that cannot replace its target leaves it and no temporary
+        const char* blocked = "test_output_async_dir";
+        assert(::mkdir(blocked, 0700) == 0);
+        bool refused = false;
+        try {
+            yini::sync_wait(ring, yini::async_write_file(ring, blocked, std::string("a = 1\n")));
+        } catch (const yini::FileError&) {
+            refused = true;
+        }
+        struct stat blocked_info {};
+        assert(refused && ::stat(blocked, &blocked_info) == 0 && S_ISDIR(blocked_info.st_mode));
+        assert(::rmdir(blocked) == 0);
+        for (const auto& entry : std::filesystem::directory_iterator(".")) {
+            assert(entry.path().filename().string().rfind("test_output_async_dir.", 0) != 0);
+        }
+
+        io_uring_queue_exit(&ring);
+        std::cout << "All tests passed" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+#else
+
+int main() {
+    std::cout << "Built without coroutine or liburing support; skipping" << std::endl;
+    std::cout << "All tests passed" << std::endl;
+    return 0;
+}
+
+#endif
@@ -1,5 +1,7 @@
 #include <iostream>
 #include <cassert>
+#include <cstdint>
+#include <type_traits>
 #include "yini.hpp"
 
 int main() {
@@ -54,6 +56,158 @@ int main() {
         
         yini::Value string_bool("true");
         assert(string_bool.as_bool() == true);
+        assert(yini::Value("On").as_bool() == true);
+        assert(yini::Value("2.5").as_double() == 2.5);
+
+        bool caught_conversion = false;
+        try {
+            yini::Value("abc").as_int();
+        } catch (const std::runtime_error&) {
+            caught_conversion = true;
+        }
+        assert(caught_conversion);
+
+        assert(yini::Value(static_cast<unsigned long long>(INT64_MAX)).is_int());
+        bool caught_unsigned = false;
+        try {
+            yini::Value(static_cast<unsigned long long>(INT64_MAX) + 1);
+        } catch (const std::out_of_range&) {
+            caught_unsigned = true;
+        }
+        assert(caught_unsigned);
+
+        // Assignment rejects the same values as the constructor
+        yini::Value assigned(1);
+        caught_unsigned = false;
+        try {
+            assigned = UINT64_MAX;
+        } catch (const std::out_of_range&) {
+            caught_unsigned = true;
+        }
+        assert(caught_unsigned && assigned.as_int() == 1);
+        yini::Parser unsigned_parser;
+        unsigned_parser["k"] = 7;
+        caught_unsigned = false;
+        try {
+            unsigned_parser["k"] = 1ull << 63;
+        } catch (const std::out_of_range&) {
+            caught_unsigned = true;
+        }
+        assert(caught_unsigned && unsigned_parser["k"].as_int() == 7);
+        
+        // Test 6: Non-copying accessors
+        std::cout << "Testing non-copying accessors..." << std::endl;
+        yini::Value text(std::string("a fairly long string value"));
+        assert(text.as_string_view() == "a fairly long string value");
+        assert(text.get_if<std::string>() != nullptr);
+        assert(text.get_if<std::int64_t>() == nullptr);
+        
+        yini::Value list(std::vector<yini::Value>{yini::Value(1), yini::Value("two")});
+        const std::vector<yini::Value>& items = list.array_ref();
+        assert(items.size() == 2);
+        assert(&items == &list.array_ref());
+        list.array_ref().push_back(yini::Value(3.0));
+        assert(list.array_ref().size() == 3);
+        
+        size_t visited = list.visit([](const auto& held) -> size_t {
+            using T = std::decay_t<decltype(held)>;
+            if constexpr (std::is_same_v<T, std::vector<yini::Value>>) return held.size();
+            return 0;
+        });
+        assert(visited == 3);
+        
+        yini::Value moved(std::move(list));
+        assert(moved.is_array() && moved.array_ref().size() == 3);
+        yini::Value target;
+        target = std::move(moved);
+        assert(target.array_ref()[1].as_string_view() == "two");
+        
+        bool caught_view = false;
+        try {
+            yini::Value(42).as_string_view();
+        } catch (const std::runtime_error&) {
+            caught_view = true;
+        }
+        assert(caught_view);
+        
+        // Test 7: Packed numeric arrays
+        std::cout << "Testing packed arrays..." << std::endl;
+        yini::Parser packed_parser;
+        packed_parser.parse_string("ints = [1, -2, 3]\nreals = [0.5, 1e3]\nmixed = [1, 2.5]\nnested = [[1, 2], [3]]\nempty = []");
+        const yini::Value& ints = packed_parser["ints"];
+        assert(ints.is_array() && ints.get_if<yini::PackedArray>() != nullptr);
+        yini::Span<const std::int64_t> int_view = ints.int_span();
+        assert(int_view.size() == 3 && int_view[1] == -2);
+        yini::Span<const double> real_view = packed_parser["reals"].double_span();
+        assert(real_view.size() == 2 && real_view[1] == 1000.0);
+        assert(packed_parser["mixed"].get_if<yini::PackedArray>() == nullptr);
+        assert(packed_parser["nested"].array_ref()[0].int_span().size() == 2);
+        // An empty array has no element kind: it stays plain and both spans are empty
+        const yini::Value& empty = packed_parser["empty"];
+        assert(empty.is_array() && empty.array_ref().empty());
+        assert(empty.get_if<std::vector<yini::Value>>() != nullptr);
+        assert(empty.int_span().empty() && empty.double_span().empty());
+        assert(yini::Value(std::vector<double>()).int_span().empty());
+        assert(empty == yini::Value(std::vector<std::int64_t>()));
+        assert(packed_parser["mixed"].array_ref()[0].is_int() && packed_parser["mixed"].array_ref()[1].is_double());
+        yini::Parser late_mix;
+        late_mix.parse_string("items = [1, 2, [3], 'four', 5]");
+        assert(late_mix["items"].get_if<yini::PackedArray>() == nullptr);
+        assert(late_mix.write_string() == "items = [1, 2, [3], 'four', 5]\n");
+        
+        bool caught_span = false;
+        try {
+            packed_parser["reals"].int_span();
+        } catch (const std::runtime_error&) {
+            caught_span = true;
+        }
+        assert(caught_span);
+        
+        // Boxed views are built once and compare equal to plain arrays
+        const yini::Value& const_ints = ints;
+        assert(&const_ints.array_ref() == &const_ints.array_ref());
+        assert(const_ints.array_ref()[2].as_int() == 3);
+        assert(ints == yini::Value(std::vector<yini::Value>{yini::Value(1), yini::Value(-2), yini::Value(3)}));
+        assert(ints != packed_parser["reals"]);
+        yini::Value shared_copy = ints;
+        assert(shared_copy.int_span().data() == int_view.data());
+        assert(packed_parser.write_string().find("ints = [1, -2, 3]") != std::string::npos);
+        
+        // Mutable access turns the value into a plain array
+        packed_parser["ints"].array_ref().push_back(yini::Value("four"));
+        assert(packed_parser["ints"].get_if<yini::PackedArray>() == nullptr);
+        assert(packed_parser["ints"].array_ref().size() == 4 && shared_copy.int_span().size() == 3);
+        
+        yini::Value table(std::vector<std::int64_t>(100000, 7));
+        assert(table.int_span().size() == 100000 && table.as_array().size() == 100000);
+        
+        // Test 8: Interned keys
+        std::cout << "Testing interned keys..." << std::endl;
+        yini::Atom host_key = yini::intern("host");
+        yini::Atom port_key = yini::intern("port");
+        size_t interned = yini::interned_count();
+        assert(yini::intern(std::string("ho") + "st") == host_key);
+        assert(host_key != port_key && yini::interned_count() == interned);
+        assert(host_key.str() == "host" && yini::Atom().str().empty());
+        
+        yini::Parser atoms;
+        atoms.parse_string("host = 'a'\n^ db\n    host = 'b'\n    port = 5432");
+        assert(atoms.root().at(host_key).as_string() == "a");
+        assert(!atoms.root().has_value(port_key) && atoms.root().find_value(port_key) == nullptr);
+        yini::Atom db_key = yini::intern("db");
+        const yini::Section* db = atoms.root().find_section(db_key);
+        assert(db && db->at(port_key).as_int() == 5432 && db->has_value(host_key));
+        atoms.section(db_key)[port_key] = 6543;
+        atoms[port_key] = 1;
+        assert(atoms.find("db.port")->as_int() == 6543 && atoms["port"].as_int() == 1);
+        
+        bool caught_atom = false;
+        try {
+            db->at(yini::intern("missing"));
+        } catch (const std::out_of_range&) {
+            caught_atom = true;
+        }
+        assert(caught_atom);
         
         std::cout << "All tests passed" << std::endl;
         
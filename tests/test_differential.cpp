@@ -0,0 +1,126 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include "differential.hpp"
+#include "corpus.hpp"
+
+namespace {
+
+// Small edits that hit the lexer's and splitter's special cases
+std::string mutate(const std::string& seed, yini_bench::Random& random) {
+    static const char alphabet[] = "^^==//**''\"[],\n\n \t.0123456789-+eEfalsetrue";
+    std::string text = seed;
+    size_t edits = 1 + random.below(4);
+    for (size_t i = 0; i < edits && !text.empty(); ++i) {
+        size_t at = random.below(text.size());
+        char c = alphabet[random.below(sizeof(alphabet) - 1)];
+        switch (random.below(5)) {
+            case 0: text[at] = c; break;
+            case 1: text.insert(text.begin() + static_cast<std::ptrdiff_t>(at), c); break;
+            case 2: text.erase(at, 1 + random.below(3)); break;
+            case 3: {
+                // Duplicate a line somewhere else
+                size_t start = text.rfind('\n', at);
+                start = start == std::string::npos ? 0 : start + 1;
+                size_t end = text.find('\n', at);
+                end = end == std::string::npos ? text.size() : end + 1;
+                text.insert(random.below(text.size() + 1), text.substr(start, end - start));
+                break;
+            }
+            default: text.insert(at, "\n^ s" + std::to_string(random.below(3)) + "\n"); break;
+        }
+    }
+    return text;
+}
+
+std::string escaped(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '\n') {
+            out += "\\n";
+        } else if (c == '\t') {
+            out += "\\t";
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Running differential tests..." << std::endl;
+
+    std::vector<std::string> seeds;
+    {
+        std::ifstream in("example.yini");
+        seeds.emplace_back(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        assert(!seeds.back().empty());
+    }
+    seeds.push_back("");
+    seeds.push_back("a = 1\n^ s\n    b = [1, 2.5, 'x', [true]]\n^^ t\nc = -3\n^ s\nd = 'reopened'\n");
+    seeds.push_back("/* block\n^ hidden\n*/ ^ shown // trailing\n    x = 'a/b' /* inline */ y\n    n = [1, 2, 3]\n");
+    seeds.push_back("k = 0.5\nk = 2e3\nlist = [1e3, -0.0, 7.25]\n^ a\n^^ b\n^^^ c\n    deep = yes\n^ a\n^^ b\n    more = no\n");
+    for (std::uint64_t seed = 1; seed <= 4; ++seed) {
+        yini_bench::CorpusOptions options;
+        options.target_bytes = 2048;
+        options.depth = static_cast<int>(seed % 4);
+        options.array_width = static_cast<size_t>(seed * 3 % 7);
+        options.comment_density = 0.3;
+        options.seed = seed;
+        seeds.push_back(yini_bench::generate_corpus(options));
+    }
+
+    try {
+        // Test 1: Seeds agree on every path
+        std::cout << "Testing seed inputs..." << std::endl;
+        for (const std::string& seed : seeds) {
+            std::string failure = yini_check::check(seed);
+            if (!failure.empty()) {
+                std::cerr << failure << "\nInput: " << escaped(seed) << std::endl;
+                return 1;
+            }
+        }
+
+        // Test 2: Mutated inputs agree as well, accepted or not
+        std::cout << "Testing mutated inputs..." << std::endl;
+        yini_bench::Random random(2024);
+        size_t accepted = 0;
+        const size_t rounds = 400;
+        for (size_t round = 0; round < rounds; ++round) {
+            for (const std::string& seed : seeds) {
+                std::string input = mutate(seed, random);
+                std::string failure = yini_check::check(input);
+                if (!failure.empty()) {
+                    std::cerr << failure << "\nInput: " << escaped(input) << std::endl;
+                    return 1;
+                }
+                try {
+                    yini::Parser probe;
+                    probe.parse_string(input);
+                    ++accepted;
+                } catch (const yini::ParseError&) {
+                }
+            }
+        }
+        // Both outcomes must be exercised for the check to mean anything.
+        // Not an assert: this must hold in NDEBUG builds too
+        if (accepted <= rounds || accepted >= rounds * seeds.size() - rounds) {
+            std::cerr << "Mutations are not exercising both outcomes: " << accepted << " of "
+                      << rounds * seeds.size() << " accepted" << std::endl;
+            return 1;
+        }
+
+        std::cout << "All tests passed" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,282 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <memory_resource>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include "yini.hpp"
+
+int main() {
+    std::cout << "Running document tests..." << std::endl;
+    
+    try {
+        // Test 1: Basic parsing into the arena
+        std::cout << "Testing basic document parsing..." << std::endl;
+        yini::Document doc;
+        
+        doc.parse(R"(
+name = 'demo'
+port = 8080
+ratio = 0.75
+enabled = yes
+tags = ['a', 'b', 'c']
+)");
+        
+        assert(doc.root().at("name").as_string() == "demo");
+        assert(doc.root().at("port").as_int() == 8080);
+        assert(doc.root().at("ratio").as_double() == 0.75);
+        assert(doc.root().at("enabled").as_bool() == true);
+        
+        auto tags = doc.root().at("tags").as_array();
+        assert(tags.size() == 3);
+        assert(tags[0].as_string() == "a");
+        assert(tags[2].as_string() == "c");
+        assert(!doc.root().has_value("missing"));
+        
+        // Test 2: Nested sections and source order
+        std::cout << "Testing nested document sections..." << std::endl;
+        doc.parse_file("example.yini");
+        
+        const yini::DocSection& server = doc.root().get_section("server");
+        assert(server.get_section("connection").at("host").as_string() == "localhost");
+        assert(server.get_section("connection").at("port").as_int() == 8080);
+        assert(server.get_section("auth").get_section("credentials").at("username").as_string() == "admin");
+        assert(doc.root().sections()[0]->name() == "server");
+        assert(doc.root().sections()[1]->name() == "database");
+        assert(server.get_section("connection").values()[0].key == "host");
+        
+        // Test 3: Large sections switch to an index
+        std::cout << "Testing indexed lookup..." << std::endl;
+        std::string many = "^ flags\n";
+        for (int i = 0; i < 200; ++i) {
+            many += "flag_" + std::to_string(i) + " = " + std::to_string(i) + "\n";
+        }
+        many += "flag_7 = 'overridden'\n^ flags\nextra = true\n";
+        doc.parse(many);
+        
+        const yini::DocSection& flags = doc.root().get_section("flags");
+        assert(flags.values().size() == 201);
+        assert(flags.at("flag_150").as_int() == 150);
+        assert(flags.at("flag_7").as_string() == "overridden");
+        assert(flags.at("extra").as_bool());
+        assert(doc.root().sections().size() == 1);
+        
+        // Test 4: Caller-supplied memory resource
+        std::cout << "Testing custom memory resource..." << std::endl;
+        char buffer[16384];
+        std::pmr::monotonic_buffer_resource upstream(buffer, sizeof(buffer));
+        yini::Document bounded(&upstream);
+        bounded.parse("^ a\n    ^^ b\n    key = 'value'\n");
+        assert(bounded.root().get_section("a").get_section("b").at("key").as_string() == "value");
+        assert(bounded.root().get_section("a").get_section("b").at("key").to_value().as_string() == "value");
+        
+        // Test 5: Errors
+        std::cout << "Testing document errors..." << std::endl;
+        bool caught_exception = false;
+        try {
+            doc.parse("no equals here");
+        } catch (const yini::ParseError&) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+        
+        bool caught_missing = false;
+        try {
+            doc.root().get_section("nope");
+        } catch (const std::out_of_range&) {
+            caught_missing = true;
+        }
+        assert(caught_missing);
+        
+        // Test 6: Compact values
+        std::cout << "Testing compact values..." << std::endl;
+        static_assert(sizeof(yini::DocValue) <= 16, "DocValue must stay compact");
+        
+        doc.parse(R"(
+short = 'fourteen bytes'
+long = 'this string does not fit inline'
+empty = ''
+big = 10737418240
+list = [1, 'two', 3.5, false]
+)");
+        
+        assert(doc.root().at("short").as_string() == "fourteen bytes");
+        assert(doc.root().at("long").as_string() == "this string does not fit inline");
+        assert(doc.root().at("empty").as_string().empty());
+        assert(doc.root().at("big").as_int64() == 10737418240LL);
+        
+        auto list = doc.root().at("list").as_array();
+        assert(list.size() == 4);
+        assert(list[0].as_int() == 1);
+        assert(list[1].as_string() == "two");
+        assert(list[2].as_double() == 3.5);
+        assert(list[3].as_bool() == false);
+        
+        doc.parse("grid = [[1, 2], ['x, y']]\n");
+        auto grid = doc.root().at("grid").as_array();
+        assert(grid.size() == 2);
+        assert(grid[0].as_array()[1].as_int() == 2);
+        assert(grid[1].as_array()[0].as_string() == "x, y");
+        
+        doc.parse("list = [1, 'two', 3.5, false]\nbig = 10737418240\n");
+        yini::Value copied = doc.root().at("list").to_value();
+        assert(copied.array_ref()[1].as_string() == "two");
+        assert(doc.root().at("big").to_value().as_int64() == 10737418240LL);
+        
+        // Test 7: Frozen documents
+        std::cout << "Testing frozen documents..." << std::endl;
+        yini::Parser source;
+        source.parse_file("example.yini");
+        for (int i = 0; i < 100; ++i) {
+            source.section("many")["key" + std::to_string(i)] = i;
+        }
+        
+        yini::FrozenDocument frozen = source.freeze();
+        const yini::FrozenSection& frozen_server = frozen.get_section("server");
+        assert(frozen_server.get_section("connection").at("host").as_string() == "localhost");
+        assert(frozen_server.get_section("connection").at("port").as_int() == 8080);
+        assert(frozen_server.find("missing") == nullptr);
+        assert(!frozen_server.has_section("missing"));
+        
+        const yini::FrozenSection& frozen_many = frozen.get_section("many");
+        assert(frozen_many.values().size() == 100);
+        for (int i = 0; i < 100; ++i) {
+            assert(frozen_many.at("key" + std::to_string(i)).as_int() == i);
+        }
+        for (size_t i = 1; i < frozen_many.keys().size(); ++i) {
+            assert(frozen_many.keys()[i - 1] < frozen_many.keys()[i]);
+        }
+        
+        // Independent of the source and still valid after a move
+        source.root().clear();
+        yini::FrozenDocument moved = std::move(frozen);
+        assert(moved.get_section("many").at("key42").as_int() == 42);
+        assert(moved.root().get_section("server").name() == "server");
+        
+        bool missing_key = false;
+        try {
+            moved.at("missing");
+        } catch (const std::out_of_range&) {
+            missing_key = true;
+        }
+        assert(missing_key);
+        
+        yini::FrozenDocument empty;
+        assert(empty.find("anything") == nullptr);
+        assert(empty.root().sections().empty());
+        
+        // Test 8: Lazy section materialization
+        std::cout << "Testing lazy documents..." << std::endl;
+        std::string lazy_source = "app = 'demo'\n";
+        for (int i = 0; i < 300; ++i) {
+            lazy_source += "^ section" + std::to_string(i) + " // header comment\n";
+            lazy_source += "key = " + std::to_string(i) + "\n";
+            lazy_source += "    ^^ nested\n    flag = true\n";
+        }
+        lazy_source += "/* ^ section0\n*/\n^ section1\nextra = 'reopened'\n";
+        lazy_source += "^ broken\nno equals sign\n";
+        
+        yini::LazyDocument lazy;
+        lazy.parse_string(lazy_source);
+        assert(lazy.at("app").as_string() == "demo");
+        assert(lazy.section_names().size() == 301);
+        assert(lazy.section_names()[0] == "section0");
+        assert(lazy.materialized() == 0);
+        
+        assert(lazy.get_section("section42").at("key").as_int() == 42);
+        assert(lazy.find("section7.nested.flag")->as_bool());
+        assert(lazy.get_section("section1").at("extra").as_string() == "reopened");
+        assert(lazy.get_section("section1").at("key").as_int() == 1);
+        assert(lazy.materialized() == 3);
+        assert(&lazy.get_section("section42") == &lazy.get_section("section42"));
+        assert(lazy.find_section("missing") == nullptr);
+        
+        bool lazy_error = false;
+        try {
+            lazy.get_section("broken");
+        } catch (const yini::ParseError& e) {
+            lazy_error = std::string(e.what()).find("line " + std::to_string(1 + 300 * 4 + 6)) != std::string::npos;
+        }
+        assert(lazy_error);
+        
+        std::vector<std::thread> lazy_readers;
+        std::atomic<int> lazy_hits{0};
+        for (int t = 0; t < 4; ++t) {
+            lazy_readers.emplace_back([&]() {
+                for (int i = 100; i < 200; ++i) {
+                    if (lazy.get_section("section" + std::to_string(i)).at("key").as_int() == i) ++lazy_hits;
+                }
+            });
+        }
+        for (std::thread& reader : lazy_readers) reader.join();
+        assert(lazy_hits == 400);
+        assert(lazy.materialized() == 103);
+        
+        yini::LazyDocument lazy_file;
+        lazy_file.parse_file("example.yini");
+        assert(lazy_file.find("server.connection.host")->as_string() == "localhost");
+        
+        // Test 9: Layered documents
+        std::cout << "Testing layered documents..." << std::endl;
+        auto layer_from = [](const std::string& text) {
+            yini::Parser layer_parser;
+            layer_parser.parse_string(text);
+            return std::make_shared<yini::Section>(std::move(layer_parser.root()));
+        };
+        yini::Layered layered({
+            layer_from("timeout = 30\n^ db\n    host = 'localhost'\n    port = 5432\n    ^^ pool\n        size = 4"),
+            layer_from("^ db\n    host = 'db.eu'\n^ cache\n    ttl = 60"),
+        });
+        layered.push_layer(layer_from("timeout = 5\n^ db\n    ^^ pool\n        size = 32"));
+        assert(layered.layer_count() == 3);
+        assert(layered.size() == 5);
+        assert(layered.at("timeout").as_int() == 5 && layered.layer_of("timeout") == 2);
+        assert(layered.at("db.host").as_string() == "db.eu" && layered.layer_of("db.host") == 1);
+        assert(layered.at("db.port").as_int() == 5432 && layered.layer_of("db.port") == 0);
+        assert(layered.at("db.pool.size").as_int() == 32);
+        assert(layered.at("cache.ttl").as_int() == 60);
+        assert(!layered.has_value("db.pool") && !layered.find("missing.key"));
+        
+        // Replacing the region layer re-resolves only what it touched
+        yini::Section region = layered.layer(1).clone();
+        region.section("cache")["ttl"] = 120;
+        region.section("db").erase_value("host");
+        layered.set_layer(1, std::make_shared<yini::Section>(std::move(region)));
+        assert(layered.at("db.host").as_string() == "localhost" && layered.layer_of("db.host") == 0);
+        assert(layered.at("cache.ttl").as_int() == 120);
+        assert(layered.at("db.pool.size").as_int() == 32);
+        
+        layered.set_layer(1, nullptr);
+        assert(!layered.has_value("cache.ttl") && layered.size() == 4);
+        bool layered_missing = false;
+        try {
+            layered.layer_of("cache.ttl");
+        } catch (const std::out_of_range&) {
+            layered_missing = true;
+        }
+        assert(layered_missing);
+        
+        // Names that contain a dot are indexed under their exact segments
+        yini::Parser dotted;
+        dotted["a.b"] = 1;
+        dotted.section("net")["ip.v4"] = "10.0.0.1";
+        yini::Layered dotted_layers({std::make_shared<yini::Section>(std::move(dotted.root()))});
+        assert(dotted_layers.at("a.b").as_int() == 1);
+        assert(dotted_layers.at("net.ip.v4").as_string() == "10.0.0.1");
+        dotted_layers.push_layer(layer_from("^ net\n    mask = 8"));
+        yini::Section dotted_top = dotted_layers.layer(1).clone();
+        dotted_top["a.b"] = 2;
+        dotted_layers.set_layer(1, std::make_shared<yini::Section>(std::move(dotted_top)));
+        assert(dotted_layers.at("a.b").as_int() == 2 && dotted_layers.layer_of("a.b") == 1);
+        assert(dotted_layers.at("net.ip.v4").as_string() == "10.0.0.1" && dotted_layers.size() == 3);
+        
+        std::cout << "All tests passed" << std::endl;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
@@ -1,8 +1,36 @@
 #include <iostream>
 #include <cassert>
 #include <string>
+#include <cstdio>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <type_traits>
 #include "yini.hpp"
 
+// Records SAX events as text
+struct RecordingVisitor : yini::Visitor {
+    std::string log;
+
+    void on_section_enter(yini::Span<const std::string_view> path, int depth) {
+        log += "enter(" + std::to_string(depth) + ":";
+        for (std::string_view name : path) log += "/" + std::string(name);
+        log += ")";
+    }
+
+    void on_value(std::string_view key, yini::TokenKind kind, std::string_view raw) {
+        log += std::string(key) + "#" + std::to_string(static_cast<int>(kind)) + "=" + std::string(raw) + ";";
+    }
+
+    void on_section_exit(yini::Span<const std::string_view> path, int depth) {
+        log += "exit(" + std::to_string(depth) + ":" + std::string(path[path.size() - 1]) + ")";
+    }
+};
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
 int main() {
     std::cout << "Running parser tests..." << std::endl;
     
@@ -141,6 +169,609 @@ name = 'test'
         assert(parser.section("server").section("connection")["port"].as_int() == 8080);
         assert(parser.section("server").section("auth")["enabled"].as_bool() == true);
         
+        // Test 8: Zero-copy parse over a string_view
+        std::cout << "Testing string_view parsing..." << std::endl;
+
+        std::string_view view_config =
+            "^ server /* block */\n"
+            "    host = /* inline */ 'localhost'\r\n"
+            "    port = 8080 /* spans\n"
+            "    several lines */\n"
+            "    name = 'a /* gap */ b'\n"
+            "    mode = 'fast' // trailing\n"
+            "    /* unclosed comment";
+
+        parser.parse(view_config);
+
+        assert(parser.section("server")["host"].as_string() == "localhost");
+        assert(parser.section("server")["port"].as_int() == 8080);
+        assert(parser.section("server")["name"].as_string() == "a  b");
+        assert(parser.section("server")["mode"].as_string() == "fast");
+
+        bool caught_line = false;
+        try {
+            parser.parse("a = 1\n/* one\n two */\nbroken line\n");
+        } catch (const yini::ParseError& e) {
+            caught_line = std::string(e.what()).find("line 4") != std::string::npos;
+        }
+        assert(caught_line);
+
+        // Test 9: Scalar classification
+        std::cout << "Testing scalar classification..." << std::endl;
+
+        std::string scalar_config = R"(
+ident = localhost
+scientific = 1e-5
+suffixed = 8080abc
+positive = +5
+negative = -3
+not_a_number = inf
+shouted = TRUE
+dotted = 1.2.3
+)";
+
+        parser.parse_string(scalar_config);
+
+        assert(parser["ident"].is_string() && parser["ident"].as_string() == "localhost");
+        assert(parser["scientific"].is_double() && parser["scientific"].as_double() == 1e-5);
+        assert(parser["suffixed"].is_string());
+        assert(parser["positive"].is_int() && parser["positive"].as_int() == 5);
+        assert(parser["negative"].is_int() && parser["negative"].as_int() == -3);
+        assert(parser["not_a_number"].is_string());
+        assert(parser["shouted"].is_bool() && parser["shouted"].as_bool() == true);
+        assert(parser["dotted"].is_string());
+
+        // Test 10: Section stack across siblings, returns and reopened headers
+        std::cout << "Testing section stack..." << std::endl;
+
+        std::string stack_config = R"(
+^ a
+    ^^ b
+        ^^^ c
+        deep = 3
+    ^^ d
+    mid = 2
+^ e
+top = 1
+^ a
+    ^^ b
+    again = true
+)";
+
+        parser.parse_string(stack_config);
+
+        assert(parser.section("a").section("b").section("c")["deep"].as_int() == 3);
+        assert(parser.section("a").section("d")["mid"].as_int() == 2);
+        assert(parser.section("e")["top"].as_int() == 1);
+        assert(parser.section("a").section("b")["again"].as_bool() == true);
+        assert(parser.section("a").section("b").has_section("c"));
+
+        // Test 11: Mapped files and the chunked read fallback
+        std::cout << "Testing file sources..." << std::endl;
+
+        {
+            yini::detail::FileSource mapped("example.yini");
+            assert(mapped.mapped());
+            assert(mapped.view().find("^ server") != std::string_view::npos);
+        }
+
+        bool caught_missing = false;
+        try {
+            parser.parse_file("does_not_exist.yini");
+        } catch (const yini::FileError&) {
+            caught_missing = true;
+        }
+        assert(caught_missing);
+
+#if defined(__linux__)
+        // Side effects stay outside assert() so NDEBUG builds still run them
+        int fds[2];
+        int piped_status = pipe(fds);
+        assert(piped_status == 0);
+        std::string piped = "^ pipe\n    value = 7\n";
+        ssize_t written = write(fds[1], piped.data(), piped.size());
+        assert(written == static_cast<ssize_t>(piped.size()));
+        close(fds[1]);
+
+        parser.parse_file("/dev/fd/" + std::to_string(fds[0]));
+        close(fds[0]);
+        assert(parser.section("pipe")["value"].as_int() == 7);
+#endif
+
+        // Test 12: Push parsing in arbitrary chunk sizes
+        std::cout << "Testing push parsing..." << std::endl;
+
+        std::string push_config = R"(
+/* leading
+   comment */ ^ server
+    host = 'local/* not */host' // trailing
+    path = '/var/log'
+    /**/ port = 8080 /* split
+    */ ratio = 0.5
+    ^^ nested
+    list = [1, 2, 3]
+)";
+
+        yini::Parser reference;
+        reference.parse_string(push_config);
+        std::string expected = reference.write_string();
+
+        for (size_t chunk : {1, 2, 3, 5, 7, 64}) {
+            yini::Parser pushed;
+            for (size_t offset = 0; offset < push_config.size(); offset += chunk) {
+                pushed.feed(std::string_view(push_config).substr(offset, chunk));
+            }
+            pushed.finish();
+            assert(pushed.write_string() == expected);
+        }
+        assert(reference.section("server")["host"].as_string() == "localhost");
+        assert(reference.section("server")["path"].as_string() == "/var/log");
+        assert(reference.section("server")["port"].as_string() == "8080  ratio = 0.5");
+
+        yini::Parser partial;
+        partial.feed("^ live\n    ready = tr");
+        assert(partial.section("live").has_value("ready") == false);
+        partial.feed("ue\n");
+        assert(partial.section("live")["ready"].as_bool() == true);
+        partial.finish();
+
+        bool caught_stream = false;
+        try {
+            partial.feed("a = 1\nbroken\n");
+        } catch (const yini::ParseError&) {
+            caught_stream = true;
+        }
+        assert(caught_stream);
+
+        // A parser moved between feed() calls keeps the partial line and the open section
+        yini::Parser moving;
+        moving.feed("^ outer\n    ^^ inner\n        a = 1");
+        yini::Parser moved(std::move(moving));
+        moved.feed("2\n        b = 3\n");
+        yini::Parser assigned;
+        assigned = std::move(moved);
+        assigned.feed("^ tail\n    c = 4\n");
+        assigned.finish();
+        assert(assigned.find("outer.inner.a")->as_int() == 12);
+        assert(assigned.find("outer.inner.b")->as_int() == 3);
+        assert(assigned.find("tail.c")->as_int() == 4);
+
+        // Test 13: SAX events
+        std::cout << "Testing SAX events..." << std::endl;
+
+        std::string sax_config = R"(
+top = 'x'
+^ a
+    n = 1
+    ^^ b
+    list = [1, 'two']
+^ c
+        ^^^ deep
+        flag = on
+)";
+
+        RecordingVisitor recorder;
+        yini::sax_parse(sax_config, recorder);
+        assert(recorder.log ==
+               "top#0=x;"
+               "enter(1:/a)n#1=1;"
+               "enter(2:/a/b)list#4=[1, 'two'];exit(2:b)exit(1:a)"
+               "enter(1:/c)enter(2:/c/)enter(3:/c//deep)flag#3=on;"
+               "exit(3:deep)exit(2:)exit(1:c)");
+
+        RecordingVisitor streamed;
+        yini::EventReader<RecordingVisitor> reader(streamed);
+        for (size_t offset = 0; offset < sax_config.size(); offset += 4) {
+            std::string_view chunk = std::string_view(sax_config).substr(offset, 4);
+            reader.feed(chunk.data(), chunk.size());
+        }
+        reader.finish();
+        assert(streamed.log == recorder.log);
+
+        std::vector<std::string> elements;
+        yini::for_each_element("[1, 'two', 3.5]", [&](yini::TokenKind kind, std::string_view raw) {
+            elements.push_back(std::to_string(static_cast<int>(kind)) + std::string(raw));
+        });
+        assert(elements.size() == 3 && elements[0] == "11" && elements[1] == "0two" && elements[2] == "23.5");
+
+        // Test 14: 64-bit integers
+        std::cout << "Testing 64-bit integers..." << std::endl;
+
+        parser.parse_string("bytes = 10737418240\nstamp = -1700000000000\nsmall = 12\n");
+
+        assert(parser["bytes"].is_int());
+        assert(parser["bytes"].as_int64() == 10737418240LL);
+        assert(parser["stamp"].as_int64() == -1700000000000LL);
+        assert(parser["small"].as_int() == 12);
+
+        bool caught_range = false;
+        try {
+            parser["bytes"].as_int();
+        } catch (const std::out_of_range&) {
+            caught_range = true;
+        }
+        assert(caught_range);
+
+        // Test 15: Nested arrays and quoted commas
+        std::cout << "Testing nested arrays..." << std::endl;
+
+        std::string nested_arrays = R"(
+matrix = [[1, 2], [3, 4, 5], []]
+quoted = ['a, b', "c]d", 'e']
+deep = [[[1]], 2]
+not_array = [1, 2] , [3]
+empty_items = [1, , 2, ]
+)";
+
+        parser.parse_string(nested_arrays);
+
+        const auto& matrix = parser["matrix"].array_ref();
+        assert(matrix.size() == 3);
+        assert(matrix[0].array_ref().size() == 2);
+        assert(matrix[1].array_ref()[2].as_int() == 5);
+        assert(matrix[2].is_array() && matrix[2].array_ref().empty());
+
+        const auto& quoted = parser["quoted"].array_ref();
+        assert(quoted.size() == 3);
+        assert(quoted[0].as_string() == "a, b");
+        assert(quoted[1].as_string() == "c]d");
+
+        assert(parser["deep"].array_ref()[0].array_ref()[0].array_ref()[0].as_int() == 1);
+        assert(parser["not_array"].is_string());
+        assert(parser["empty_items"].array_ref().size() == 2);
+
+        yini::Parser nested_round_trip;
+        nested_round_trip.parse_string(parser.write_string());
+        assert(nested_round_trip["matrix"].array_ref()[1].array_ref()[1].as_int() == 4);
+        assert(nested_round_trip["quoted"].array_ref()[0].as_string() == "a, b");
+
+        // Test 16: Dotted paths and precompiled path handles
+        std::cout << "Testing dotted path lookup..." << std::endl;
+        parser.parse_file("example.yini");
+        const yini::Parser& const_parser = parser;
+        const yini::Value* host = const_parser.find("server.connection.host");
+        assert(host && host->as_string() == "localhost");
+        assert(const_parser.find("server.connection.missing") == nullptr);
+        assert(const_parser.find("server.nowhere.host") == nullptr);
+        assert(!parser.root().get_section("server").has_section("nowhere"));
+
+        yini::Path port_path = yini::compile_path("server.connection.port");
+        assert(port_path.segments().size() == 3);
+        for (int i = 0; i < 3; ++i) {
+            assert(parser.find(port_path)->as_int() == 8080);
+        }
+        assert(parser.find(yini::compile_path("server.connection")) == nullptr);
+
+        std::string_view key_view = std::string_view("host=x").substr(0, 4);
+        assert(parser.root().get_section("server").get_section("connection").has_value(key_view));
+        assert(parser.root().find_section("server") != nullptr);
+
+        // Many keys exercise index growth; iteration follows insertion order
+        yini::Section grown;
+        for (int i = 0; i < 1000; ++i) {
+            grown["key" + std::to_string(i)] = i;
+        }
+        const yini::Value& first_value = grown.at("key0");
+        for (int i = 0; i < 1000; ++i) {
+            assert(grown.at("key" + std::to_string(i)).as_int() == i);
+        }
+        assert(&first_value == &grown.at("key0"));
+        int expected_index = 0;
+        for (auto it = grown.values_begin(); it != grown.values_end(); ++it) {
+            assert(it->first == "key" + std::to_string(expected_index++));
+        }
+
+        // Test 17: Parallel parsing
+        std::cout << "Testing parallel parsing..." << std::endl;
+        std::string large = "root_key = 1\n";
+        for (int i = 0; i < 4000; ++i) {
+            std::string name = "group" + std::to_string(i % 50);
+            large += "^ " + name + "\n";
+            large += "id" + std::to_string(i) + " = " + std::to_string(i) + "\n";
+            large += "^^ child\nlast = " + std::to_string(i) + "\n";
+            large += "/* ^ not_a_header\n^ still_comment */ note = 'x'\n";
+            large += "// ^ commented_header\n";
+            large += "padding = '" + std::string(40, 'p') + "'\n";
+        }
+        large += "^ group0\nroot_key = 2\n";
+
+        yini::Parser sequential;
+        sequential.parse(large);
+        yini::Parser concurrent;
+        concurrent.parse_parallel(large, 4);
+        assert(yini::detail::split_top_level(large, 16).size() > 1);
+        assert(concurrent.write_string() == sequential.write_string());
+        assert(concurrent["root_key"].as_int() == 1);
+        assert(concurrent.find("group0.root_key")->as_int() == 2);
+        assert(concurrent.find("group7.child.last")->as_int() == 3957);
+        assert(!concurrent.root().has_section("not_a_header"));
+        assert(!concurrent.root().has_section("commented_header"));
+
+        // A header can follow a block comment on its closing line
+        std::string trailing = "^ first\na = 1\n/* note\n*/ ^ second\nb = 2\n";
+        assert(yini::detail::split_top_level(trailing, std::numeric_limits<size_t>::max()).size() == 3);
+        yini::LazyDocument trailing_lazy;
+        trailing_lazy.parse(trailing);
+        assert(trailing_lazy.section_names().size() == 2);
+        assert(trailing_lazy.get_section("second").at("b").as_int() == 2);
+        assert(!trailing_lazy.get_section("first").has_section("second"));
+
+        bool parallel_error = false;
+        try {
+            concurrent.parse_parallel(large + "broken line\n", 4);
+        } catch (const yini::ParseError& e) {
+            parallel_error = std::string(e.what()).find("line " + std::to_string(4000 * 8 + 4)) != std::string::npos;
+        }
+        assert(parallel_error);
+
+        yini::Parser base_file;
+        base_file["name"] = "base";
+        base_file.section("server")["port"] = 80;
+        base_file.section("server")["host"] = "example";
+        base_file.write_file("test_output.yini");
+        yini::Parser override_file;
+        override_file.section("server")["port"] = 8080;
+        override_file.write_file("test_output_override.yini");
+
+        std::vector<std::string> fragments = {"test_output.yini", "test_output_override.yini", "example.yini"};
+        yini::Parser merged = yini::parse_files_parallel(fragments, 3);
+        assert(merged["name"].as_string() == "base");
+        assert(merged.find("server.host")->as_string() == "example");
+        assert(merged.find("server.port")->as_int() == 8080);
+        assert(merged.find("server.connection.host")->as_string() == "localhost");
+
+        bool missing_file = false;
+        try {
+            yini::parse_files_parallel({"test_output.yini", "does_not_exist.yini"});
+        } catch (const yini::FileError&) {
+            missing_file = true;
+        }
+        assert(missing_file);
+        std::remove("test_output_override.yini");
+
+        // Test 18: Snapshots and cached reads
+        std::cout << "Testing snapshots..." << std::endl;
+        yini::Parser initial;
+        initial.parse("version = 0\n^ limits\nmax = 0\n");
+        yini::Config config(std::move(initial.root()));
+        yini::Snapshot held = config.load();
+        assert(held.find("limits.max")->as_int() == 0);
+        assert(config.load().shared() == held.shared());
+        yini::Config::Reader held_reader(config);
+        assert(held_reader.load().shared() == held.shared());
+
+        std::atomic<bool> done{false};
+        std::atomic<bool> monotonic{true};
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([&]() {
+                yini::Config::Reader reader(config);
+                std::int64_t last = 0;
+                while (!done.load()) {
+                    const yini::Snapshot& snapshot = reader.load();
+                    std::int64_t seen = snapshot.find("limits.max")->as_int64();
+                    if (seen < last || snapshot.at("version").as_int64() != seen) monotonic = false;
+                    last = seen;
+                }
+            });
+        }
+        for (int i = 1; i <= 200; ++i) {
+            yini::Section next;
+            next["version"] = i;
+            next.section("limits")["max"] = i;
+            config.update(std::move(next));
+        }
+        done = true;
+        for (std::thread& reader : readers) reader.join();
+        assert(monotonic);
+        assert(config.version() == 200);
+        assert(config.load().find("limits.max")->as_int() == 200);
+        assert(held_reader.load().find("limits.max")->as_int() == 200);
+        assert(held_reader.load().shared() == config.load().shared());
+        assert(held.find("limits.max")->as_int() == 0);
+
+        yini::Snapshot empty_snapshot;
+        assert(empty_snapshot.find("anything") == nullptr);
+
+        // Test 19: Parse statistics
+        std::cout << "Testing parse statistics..." << std::endl;
+        yini::ParseStats stats;
+        std::uint64_t fake_allocations = 0;
+        std::vector<std::string> spans;
+        stats.allocation_counter = [&fake_allocations]() { return fake_allocations += 10; };
+        stats.trace = [&spans](std::string_view span, bool begin) {
+            spans.push_back((begin ? "+" : "-") + std::string(span));
+        };
+
+        yini::Parser measured;
+        measured.parse_file("example.yini", stats);
+        yini::Parser plain;
+        plain.parse_file("example.yini");
+        assert(measured.write_string() == plain.write_string());
+
+        assert(stats.bytes > 0 && stats.lines > 0);
+        assert(stats.sections >= 4);
+        assert(stats.max_depth == 3);
+        assert(stats.keys == stats.values(yini::TokenKind::String) + stats.values(yini::TokenKind::Int) +
+                             stats.values(yini::TokenKind::Double) + stats.values(yini::TokenKind::Bool) +
+                             stats.values(yini::TokenKind::Array));
+        assert(stats.allocations == 10);
+        assert(stats.total >= stats.value_parsing + stats.tree_building);
+        assert(spans.front() == "+parse" && spans.back() == "-parse");
+        assert(std::find(spans.begin(), spans.end(), "+server") != spans.end());
+
+        measured.parse_string("a = [1, 2, 3]\nb = [[1, 2], 3, 4, 5]\nc = 'x'\n^ s\n^^ t\n^^^ u\nd = 1", stats);
+        assert(stats.lines == 7);
+        assert(stats.keys == 4 && stats.sections == 3 && stats.max_depth == 3);
+        assert(stats.values(yini::TokenKind::Array) == 2);
+        assert(stats.array_elements == 7);
+        assert(stats.largest_array == 4 && stats.largest_array_key == "b");
+        assert(spans.size() > 4);
+
+        // Test 20: Importing shared fragments
+        std::cout << "Testing fragment imports..." << std::endl;
+        yini::clear_fragment_cache();
+        {
+            yini::Parser fragment;
+            fragment["host"] = "db.local";
+            fragment["port"] = 5432;
+            fragment.section("pool")["size"] = 8;
+            fragment.write_file("test_output_fragment.yini");
+        }
+
+        yini::Parser first_app;
+        first_app.parse_string("name = 'first'\n^ services\n    api = true");
+        const yini::Section& mounted = first_app.import("test_output_fragment.yini", "services.db");
+        assert(first_app.find("services.db.host")->as_string() == "db.local");
+        assert(first_app.find("services.db.pool.size")->as_int() == 8);
+        assert(first_app.find("services.api")->as_bool());
+
+        yini::Parser second_app;
+        second_app.import("test_output_fragment.yini", "db");
+        assert(second_app.root().find_section("db") == &mounted);
+        assert(yini::fragment_cache_size() == 1);
+
+        yini::Parser merged_app;
+        merged_app["port"] = 1;
+        merged_app.import("test_output_fragment.yini", "");
+        assert(merged_app["port"].as_int() == 5432);
+        assert(merged_app.root().find_section("pool") == mounted.find_section("pool"));
+
+        // Same-named sections are merged, not replaced
+        yini::Parser reopened_app;
+        reopened_app.section("pool")["idle"] = 2;
+        reopened_app.import("test_output_fragment.yini", "");
+        assert(reopened_app.find("pool.size")->as_int() == 8 && reopened_app.find("pool.idle")->as_int() == 2);
+        assert(mounted.find_section("pool")->value_count() == 1);
+
+        // A rewritten file is parsed again; existing mounts keep the old tree
+        {
+            yini::Parser fragment;
+            fragment["host"] = "db.remote";
+            fragment.write_file("test_output_fragment.yini");
+        }
+        yini::Parser third_app;
+        third_app.import("test_output_fragment.yini", "db");
+        assert(third_app.find("db.host")->as_string() == "db.remote");
+        assert(first_app.find("services.db.host")->as_string() == "db.local");
+        std::remove("test_output_fragment.yini");
+
+        bool missing_fragment = false;
+        try {
+            third_app.import("test_output_fragment.yini", "again");
+        } catch (const yini::FileError&) {
+            missing_fragment = true;
+        }
+        assert(missing_fragment);
+        yini::clear_fragment_cache();
+        assert(yini::fragment_cache_size() == 0);
+
+        // Test 21: Copy-on-write clones and overlays
+        std::cout << "Testing copy-on-write clones..." << std::endl;
+        yini::Parser base;
+        base.parse_string("name = 'base'\n^ db\n    host = 'db.local'\n    ^^ pool\n        size = 4\n^ cache\n    ttl = 60");
+
+        yini::Parser tenant = base.clone();
+        const yini::Section* shared_cache = base.root().find_section("cache");
+        assert(tenant.root().find_section("cache") == shared_cache);
+        assert(tenant.root().find_section("db") == base.root().find_section("db"));
+
+        tenant.overlay("name = 'tenant'\n^ db\n    ^^ pool\n        size = 16");
+        assert(tenant["name"].as_string() == "tenant");
+        assert(tenant.find("db.pool.size")->as_int() == 16);
+        assert(tenant.find("db.host")->as_string() == "db.local");
+        assert(base["name"].as_string() == "base");
+        assert(base.find("db.pool.size")->as_int() == 4);
+        assert(tenant.root().find_section("cache") == shared_cache);
+        assert(tenant.root().find_section("db") != base.root().find_section("db"));
+
+        tenant.section("cache")["ttl"] = 5;
+        assert(base.find("cache.ttl")->as_int() == 60);
+        assert(base.root().find_section("cache") == shared_cache);
+
+        yini::Section layered = base.root().clone();
+        layered.merge(tenant.root());
+        assert(layered.find("db.pool.size")->as_int() == 16 && layered.find("cache.ttl")->as_int() == 5);
+        assert(tenant.find("db.pool.size")->as_int() == 16);
+        assert(base.find("db.pool.size")->as_int() == 4);
+
+        // Shared subtrees are read-only through const iteration
+        static_assert(std::is_const<std::remove_reference_t<decltype(*base.root().sections_begin()->second)>>::value,
+                      "const iteration must not expose mutable subtrees");
+        std::shared_ptr<const yini::Section> db_tree = base.root().sections_begin()->second;
+        yini::Section adopted;
+        adopted.attach("db", db_tree);
+        adopted.section("db")["host"] = "changed";
+        assert(db_tree->at("host").as_string() == "db.local");
+        assert(base.find("db.host")->as_string() == "db.local");
+
+        // Const subtrees are cloned before their first modification even
+        // when unshared; non-const ones are then modified in place
+        {
+            yini::Section frozen_source;
+            frozen_source["host"] = "const.local";
+            auto frozen = std::make_shared<const yini::Section>(std::move(frozen_source));
+            const yini::Section* frozen_address = frozen.get();
+            yini::Section holder;
+            holder.attach("const", std::move(frozen));
+            assert(holder.find_section("const") == frozen_address);
+            holder.section("const")["host"] = "copy.local";
+            assert(holder.find_section("const") != frozen_address);
+            assert(holder.find("const.host")->as_string() == "copy.local");
+
+            auto owned = std::make_shared<yini::Section>();
+            const yini::Section* owned_address = owned.get();
+            holder.attach("owned", std::move(owned));
+            holder.section("owned")["host"] = "in.place";
+            assert(holder.find_section("owned") == owned_address);
+        }
+
+        // Mounted fragments are copied before they are modified
+        {
+            yini::Parser fragment;
+            fragment["level"] = "info";
+            fragment.write_file("test_output_fragment.yini");
+        }
+        yini::Parser left;
+        yini::Parser right;
+        left.import("test_output_fragment.yini", "log");
+        right.import("test_output_fragment.yini", "log");
+        left.section("log")["level"] = "debug";
+        assert(right.find("log.level")->as_string() == "info");
+        std::remove("test_output_fragment.yini");
+        yini::clear_fragment_cache();
+
+        // Test 22: Vectorised structural scanning
+        std::cout << "Testing structural scanning..." << std::endl;
+        std::string haystack(300, 'x');
+        for (size_t hit = 0; hit < haystack.size(); ++hit) {
+            for (char found : {'\n', '/'}) {
+                haystack[hit] = found;
+                for (size_t from = 0; from < haystack.size(); from += 7) {
+                    size_t expected = from <= hit ? hit : haystack.size();
+                    assert(yini::detail::find_either(haystack.data(), from, haystack.size(), '\n', '/') == expected);
+                }
+                haystack[hit] = 'x';
+            }
+        }
+        assert(yini::detail::find_either(haystack.data(), 0, 0, '\n', '/') == 0);
+
+        std::string long_lines = "a = '" + std::string(100, 'v') + "' // " + std::string(80, 'c') + "\n/*";
+        for (int i = 0; i < 40; ++i) long_lines += std::string(i, '*') + " comment line\n";
+        long_lines += "*/ b = 1234567" + std::string(70, ' ') + "\n^ s" + std::string(50, ' ') + "\n    c = 1\n    broken\n";
+        yini::Parser scanned;
+        bool scan_error = false;
+        try {
+            scanned.parse_string(long_lines);
+        } catch (const yini::ParseError& e) {
+            scan_error = std::string(e.what()).find("line 45") != std::string::npos;
+        }
+        assert(scan_error);
+        long_lines.resize(long_lines.size() - std::string("    broken\n").size());
+        scanned.parse_string(long_lines);
+        assert(scanned["a"].as_string() == std::string(100, 'v'));
+        assert(scanned["b"].as_int() == 1234567 && scanned.find("s.c")->as_int() == 1);
+
         std::cout << "All tests passed" << std::endl;
         
     } catch (const std::exception& e) {
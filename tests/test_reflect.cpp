@@ -0,0 +1,149 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <vector>
+#include "yini.hpp"
+
+namespace app {
+
+struct Credentials {
+    std::string username;
+    std::string password;
+};
+YINI_REFLECT(Credentials, username, password)
+
+struct Auth {
+    bool enabled = false;
+    Credentials credentials;
+};
+YINI_REFLECT(Auth, enabled, credentials)
+
+struct Connection {
+    std::string host;
+    int port = 0;
+    double timeout = 0.0;
+};
+YINI_REFLECT(Connection, host, port, timeout)
+
+struct Server {
+    Connection connection;
+    Auth auth;
+};
+YINI_REFLECT(Server, connection, auth)
+
+struct AppConfig {
+    std::string name;
+    std::int64_t max_bytes = 0;
+    unsigned short workers = 1;
+    float ratio = 0.0f;
+    std::vector<int> ports;
+    std::vector<std::vector<std::string>> groups;
+    yini::Value extra;
+    Server server;
+};
+YINI_REFLECT(AppConfig, name, max_bytes, workers, ratio, ports, groups, extra, server)
+
+} // namespace app
+
+int main() {
+    std::cout << "Running reflect tests..." << std::endl;
+    
+    try {
+        // Test 1: Decoding straight from the event stream
+        std::cout << "Testing struct decoding..." << std::endl;
+        static_assert(yini::detail::is_reflected<app::AppConfig>::value, "AppConfig is reflected");
+        static_assert(!yini::detail::is_reflected<std::string>::value, "std::string is not reflected");
+        
+        app::AppConfig config = yini::decode<app::AppConfig>(R"(
+name = 'demo'
+max_bytes = 10737418240
+workers = 8
+ratio = 0.5
+ports = [80, 443]
+groups = [['a', 'b'], ['c']]
+extra = 'anything'
+unknown = 1
+
+^ server
+    ^^ connection
+    host = 'localhost'
+    port = 8080
+    timeout = 30
+    ^^ auth
+    enabled = true
+        ^^^ credentials
+        username = 'admin'
+^ ignored
+    ^^ nested
+    port = 'not a number'
+)");
+        assert(config.name == "demo");
+        assert(config.max_bytes == 10737418240LL);
+        assert(config.workers == 8);
+        assert(config.ratio == 0.5f);
+        assert(config.ports.size() == 2 && config.ports[1] == 443);
+        assert(config.groups.size() == 2 && config.groups[0][1] == "b" && config.groups[1][0] == "c");
+        assert(config.extra.as_string() == "anything");
+        assert(config.server.connection.host == "localhost");
+        assert(config.server.connection.port == 8080);
+        assert(config.server.connection.timeout == 30.0);
+        assert(config.server.auth.enabled);
+        assert(config.server.auth.credentials.username == "admin");
+        assert(config.server.auth.credentials.password.empty());
+        
+        // Missing keys keep their values
+        app::Connection connection;
+        connection.port = 1234;
+        yini::decode("host = 'example'\n", connection);
+        assert(connection.host == "example" && connection.port == 1234);
+        
+        // Test 2: Type mismatches report the line
+        std::cout << "Testing decode errors..." << std::endl;
+        bool mismatch = false;
+        try {
+            yini::decode<app::Connection>("host = 'x'\nport = 'eighty'\n");
+        } catch (const yini::ParseError& e) {
+            std::string message = e.what();
+            mismatch = message.find("line 2") != std::string::npos && message.find("'port'") != std::string::npos;
+        }
+        assert(mismatch);
+        
+        bool out_of_range = false;
+        try {
+            yini::decode<app::AppConfig>("workers = 70000\n");
+        } catch (const yini::ParseError&) {
+            out_of_range = true;
+        }
+        assert(out_of_range);
+        
+        // Test 3: Encoding without a Section tree
+        std::cout << "Testing struct encoding..." << std::endl;
+        std::string encoded = yini::encode(config);
+        app::AppConfig decoded = yini::decode<app::AppConfig>(encoded);
+        assert(decoded.name == config.name);
+        assert(decoded.max_bytes == config.max_bytes);
+        assert(decoded.ports == config.ports);
+        assert(decoded.groups == config.groups);
+        assert(decoded.server.connection.timeout == 30.0);
+        assert(decoded.server.auth.credentials.username == "admin");
+        
+        // Same layout as writing the equivalent tree
+        yini::Parser tree;
+        tree.parse(encoded);
+        assert(tree.write_string() == encoded);
+        
+        std::string sunk;
+        yini::Writer writer([&](const char* data, size_t size) { sunk.append(data, size); }, 8);
+        yini::encode(config.server, writer);
+        assert(sunk == yini::encode(config.server));
+        assert(sunk.rfind("^ connection\n", 0) == 0);
+        
+        std::cout << "All tests passed" << std::endl;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+#include "yini_watch.hpp"
+
+static void write_text(const std::string& filename, const std::string& content) {
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    out << content;
+}
+
+static bool has_change(const yini::Diff& diff, yini::Change::Kind kind, const std::string& section, const std::string& key) {
+    for (const yini::Change& change : diff) {
+        if (change.kind == kind && change.section == section && change.key == key) return true;
+    }
+    return false;
+}
+
+int main() {
+    std::cout << "Running watch tests..." << std::endl;
+    
+    try {
+        const std::string base = R"(name = 'demo'
+^ server
+port = 8080
+^^ tls
+enabled = true
+^ cache
+size = 64
+/* ^ hidden */
+^ logging
+level = 'info'
+)";
+        
+        // Test 1: Initial load
+        std::cout << "Testing initial load..." << std::endl;
+        write_text("test_watch.yini", base);
+        yini::Watcher watcher("test_watch.yini");
+        std::shared_ptr<const yini::Section> first = watcher.current();
+        assert(first->at("name").as_string() == "demo");
+        assert(first->find("server.tls.enabled")->as_bool());
+        assert(watcher.last_reparsed() == 3);
+        
+        // Test 2: Only changed sections are reparsed, the rest are shared
+        std::cout << "Testing incremental update..." << std::endl;
+        std::string edited = base;
+        edited.replace(edited.find("size = 64"), 9, "size = 128\nttl = 5");
+        yini::Diff diff;
+        assert(watcher.update(edited, &diff));
+        assert(watcher.last_reparsed() == 1);
+        
+        std::shared_ptr<const yini::Section> second = watcher.current();
+        assert(second->find("cache.size")->as_int() == 128);
+        assert(&second->get_section("server") == &first->get_section("server"));
+        assert(&second->get_section("logging") == &first->get_section("logging"));
+        assert(&second->get_section("cache") != &first->get_section("cache"));
+        assert(first->find("cache.size")->as_int() == 64);
+        
+        assert(diff.size() == 2);
+        assert(has_change(diff, yini::Change::Kind::Changed, "cache", "size"));
+        assert(has_change(diff, yini::Change::Kind::Added, "cache", "ttl"));
+        
+        // Test 3: Structural diff of added and removed sections
+        std::cout << "Testing structural diff..." << std::endl;
+        std::string restructured = edited;
+        restructured.erase(restructured.find("^ logging"));
+        restructured += "^ metrics\nport = 9100\n^^ labels\nenv = 'prod'\n";
+        assert(watcher.update(restructured, &diff));
+        assert(has_change(diff, yini::Change::Kind::Removed, "logging", "level"));
+        assert(has_change(diff, yini::Change::Kind::Added, "metrics", "port"));
+        assert(has_change(diff, yini::Change::Kind::Added, "metrics.labels", "env"));
+        assert(diff.size() == 3);
+        
+        // Unchanged text publishes nothing; any other edit publishes, even
+        // when no key changed
+        std::shared_ptr<const yini::Section> third = watcher.current();
+        assert(!watcher.update(restructured, &diff) && diff.empty());
+        assert(watcher.current() == third);
+        assert(watcher.update(restructured + "// trailing comment\n", &diff) && diff.empty());
+        assert(watcher.current() != third);
+
+        assert(watcher.update(restructured + "^ empty\n", &diff) && diff.empty());
+        assert(watcher.current()->has_section("empty"));
+        
+        // Reopened sections are merged as in a full parse
+        assert(watcher.update(restructured + "^ server\nport = 9090\n", &diff));
+        assert(watcher.current()->find("server.port")->as_int() == 9090);
+        assert(watcher.current()->find("server.tls.enabled")->as_bool());
+        assert(diff.size() == 1 && has_change(diff, yini::Change::Kind::Changed, "server", "port"));
+        
+        yini::Parser full;
+        full.parse(restructured + "^ server\nport = 9090\n");
+        yini::Writer published;
+        published.write(*watcher.current());
+        assert(published.view() == full.write_string());
+        
+        // Test 4: Errors keep the published tree
+        std::cout << "Testing update errors..." << std::endl;
+        std::shared_ptr<const yini::Section> before_error = watcher.current();
+        bool failed = false;
+        try {
+            watcher.update(restructured + "^ broken\nno equals sign\n");
+        } catch (const yini::ParseError& e) {
+            failed = std::string(e.what()).find("line 15") != std::string::npos;
+        }
+        assert(failed);
+        assert(watcher.current() == before_error);
+        
+        // Test 5: Background watching
+        std::cout << "Testing file watching..." << std::endl;
+        write_text("test_watch.yini", base);
+        watcher.reload();
+        
+        std::mutex mutex;
+        std::condition_variable notified;
+        yini::Diff seen;
+        watcher.start([&](const std::shared_ptr<const yini::Section>& tree, const yini::Diff& changes) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (tree->find("server.port")->as_int() == 8443) {
+                seen = changes;
+                notified.notify_all();
+            }
+        });
+        
+        std::string replaced = base;
+        replaced.replace(replaced.find("port = 8080"), 11, "port = 8443");
+        write_text("test_watch.yini.tmp", replaced);
+        std::rename("test_watch.yini.tmp", "test_watch.yini");
+        
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notified.wait_for(lock, std::chrono::seconds(10), [&] { return !seen.empty(); });
+        }
+        assert(seen.size() == 1 && has_change(seen, yini::Change::Kind::Changed, "server", "port"));
+        assert(watcher.current()->find("server.port")->as_int() == 8443);
+        watcher.stop();
+        std::remove("test_watch.yini");
+        
+        std::cout << "All tests passed" << std::endl;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
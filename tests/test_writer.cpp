@@ -2,6 +2,15 @@
 #include <cassert>
 #include <string>
 #include <sstream>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <limits>
+#include <filesystem>
+#include <thread>
 #include "yini.hpp"
 
 int main() {
@@ -102,6 +111,308 @@ int main() {
         assert(round_trip.section("server").section("connection")["port"].as_int() == 8080);
         assert(round_trip.section("server").section("auth")["enabled"].as_bool() == true);
         
+        // Test 6: Number formatting
+        std::cout << "Testing number formatting..." << std::endl;
+        yini::Parser number_parser;
+        number_parser["sum"] = 0.1 + 0.2;
+        number_parser["whole"] = 300.0;
+        number_parser["tiny"] = 1e-300;
+        number_parser["big"] = static_cast<std::int64_t>(9007199254740993LL);
+        
+        const yini::Parser& const_parser = number_parser;
+        std::string number_output = const_parser.write_string();
+        
+        yini::Parser number_parser2;
+        number_parser2.parse_string(number_output);
+        assert(number_parser2["sum"].as_double() == 0.1 + 0.2);
+        assert(number_parser2["whole"].is_double() && number_parser2["whole"].as_double() == 300.0);
+        assert(number_parser2["tiny"].as_double() == 1e-300);
+        assert(number_parser2["big"].as_int64() == 9007199254740993LL);
+
+        // inf and nan have no spelling that reads back as a double
+        for (double special : {std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN()}) {
+            yini::Parser special_parser;
+            special_parser["plain"] = special;
+            special_parser["packed"] = std::vector<double>{1.5, special};
+            for (const char* key : {"plain", "packed"}) {
+                yini::Parser single;
+                single[key] = special_parser[key];
+                bool caught_special = false;
+                try {
+                    single.write_string();
+                } catch (const std::runtime_error&) {
+                    caught_special = true;
+                }
+                assert(caught_special);
+            }
+        }
+        
+        // A failed write_file() leaves the existing file as it was
+        {
+            yini::Parser kept;
+            kept["key"] = "kept";
+            kept.write_file("test_output_special.yini");
+            std::string written = kept.write_string();
+            kept["bad"] = std::numeric_limits<double>::infinity();
+            bool caught_special = false;
+            try {
+                kept.write_file("test_output_special.yini");
+            } catch (const std::runtime_error&) {
+                caught_special = true;
+            }
+            assert(caught_special);
+            std::ifstream in("test_output_special.yini");
+            std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            assert(contents == written);
+        }
+        
+        // Temporaries are unique: a file that happens to share the old
+        // fixed name is left alone, and concurrent writers of one file
+        // never mix their output
+        {
+            auto read_file = [](const char* name) {
+                std::ifstream in(name);
+                return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            };
+            {
+                std::ofstream bystander("test_output_special.yini.tmp");
+                bystander << "not ours";
+            }
+            std::vector<std::string> outputs;
+            std::vector<std::thread> writers;
+            for (int i = 0; i < 4; ++i) {
+                yini::Parser variant;
+                variant["writer"] = i;
+                variant["body"] = std::string(static_cast<size_t>(20000 * (i + 1)), static_cast<char>('a' + i));
+                outputs.push_back(variant.write_string());
+                writers.emplace_back([variant = std::move(variant)]() {
+                    for (int round = 0; round < 10; ++round) variant.write_file("test_output_special.yini");
+                });
+            }
+            for (std::thread& writer : writers) writer.join();
+            std::string final_contents = read_file("test_output_special.yini");
+            assert(std::find(outputs.begin(), outputs.end(), final_contents) != outputs.end());
+            assert(read_file("test_output_special.yini.tmp") == "not ours");
+            std::remove("test_output_special.yini.tmp");
+            for (const auto& entry : std::filesystem::directory_iterator(".")) {
+                std::string name = entry.path().filename().string();
+                assert(name == "test_output_special.yini" || name.rfind("test_output_special.yini.", 0) != 0);
+            }
+        }
+        
+        // Test 7: Reusable writer with a sink
+        std::cout << "Testing buffered writer..." << std::endl;
+        std::string sunk;
+        size_t flushes = 0;
+        yini::Writer writer([&](const char* data, size_t size) {
+            sunk.append(data, size);
+            ++flushes;
+        }, 16);
+        original.write_to(writer);
+        writer.flush();
+        assert(sunk == serialized);
+        assert(flushes > 1);
+        assert(writer.view().empty());
+        
+        yini::Writer buffered;
+        original.write_to(buffered);
+        assert(buffered.view() == serialized);
+        buffered.clear();
+        file_parser.write_to(buffered);
+        assert(buffered.take() == file_parser.write_string());
+        
+        std::ostringstream stream;
+        original.write_stream(stream);
+        assert(stream.str() == serialized);
+        
+        // Test 8: Binary snapshots
+        std::cout << "Testing binary snapshots..." << std::endl;
+        original["numbers"] = numbers;
+        original["nested"] = std::vector<yini::Value>{yini::Value(std::vector<yini::Value>{yini::Value(1.5)}), yini::Value("x")};
+        original.write_file("test_output.yini");
+        original.save_binary("test_output.yinib", "test_output.yini");
+        
+        yini::Parser snapshot;
+        snapshot.load_binary("test_output.yinib");
+        assert(snapshot.write_string() == original.write_string());
+        assert(snapshot.section("server").section("connection")["host"].as_string() == "localhost");
+        assert(snapshot.section("server").section("connection")["port"].as_int() == 8080);
+        assert(snapshot.section("server").section("auth")["enabled"].as_bool() == true);
+        assert(snapshot["numbers"].array_ref().size() == 3);
+        assert(snapshot["nested"].array_ref()[0].array_ref()[0].as_double() == 1.5);
+        
+        yini::Parser checked;
+        assert(checked.load_binary("test_output.yinib", "test_output.yini"));
+        assert(checked.section("server").section("connection")["host"].as_string() == "localhost");
+        
+        // Rewriting the same text changes the mtime; the hash still matches
+        original.write_file("test_output.yini");
+        assert(checked.load_binary("test_output.yinib", "test_output.yini"));
+        
+        // A changed source makes the snapshot stale
+        file_parser.write_file("test_output.yini");
+        assert(!checked.load_binary("test_output.yinib", "test_output.yini"));
+        assert(checked["test_key"].as_string() == "test_value");
+        
+        // Corrupted snapshots are rejected
+        std::string image;
+        {
+            std::ifstream in("test_output.yinib", std::ios::binary);
+            image.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        image[image.size() / 2] ^= 0x5a;
+        {
+            std::ofstream out("test_output.yinib", std::ios::binary | std::ios::trunc);
+            out.write(image.data(), static_cast<std::streamsize>(image.size()));
+        }
+        bool rejected = false;
+        try {
+            snapshot.load_binary("test_output.yinib");
+        } catch (const yini::ParseError&) {
+            rejected = true;
+        }
+        assert(rejected);
+        assert(!checked.load_binary("test_output.yinib", "test_output.yini"));
+        assert(checked.section("test_section")["nested_key"].as_string() == "nested_value");
+
+        // Crafted images with a valid checksum but overlapping ranges are
+        // rejected without exponential work, and leave the tree untouched
+        namespace binary = yini::detail::binary;
+        auto craft = [](const std::vector<binary::SectionRecord>& sections,
+                        const std::vector<binary::ValueRecord>& values,
+                        void (*adjust)(binary::Header&) = nullptr) {
+            binary::Header header{};
+            std::memcpy(header.magic, binary::magic, sizeof(binary::magic));
+            header.version = binary::version;
+            header.byte_order = binary::byte_order;
+            header.section_count = static_cast<std::uint32_t>(sections.size());
+            header.value_count = static_cast<std::uint32_t>(values.size());
+            std::string payload(reinterpret_cast<const char*>(sections.data()),
+                                sections.size() * sizeof(binary::SectionRecord));
+            payload.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(binary::ValueRecord));
+            if (adjust) adjust(header);
+            header.payload_size = payload.size();
+            header.payload_hash = yini::detail::hash_bytes(payload);
+            std::ofstream out("test_output.yinib", std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        };
+        auto rejects = [](yini::Parser& target) {
+            try {
+                target.load_binary("test_output.yinib");
+            } catch (const yini::ParseError&) {
+                return true;
+            }
+            return false;
+        };
+
+        binary::ValueRecord good{};
+        good.kind = static_cast<std::uint8_t>(yini::TokenKind::Int);
+        binary::ValueRecord self_array{};
+        self_array.kind = static_cast<std::uint8_t>(yini::TokenKind::Array);
+        self_array.payload = binary::pack(0, 2);
+        binary::SectionRecord array_root{};
+        array_root.value_count = 1;
+        craft({array_root}, {self_array, self_array});
+        assert(rejects(snapshot));
+
+        // Forward references only, but every array shares its neighbour's
+        // elements: Fibonacci work without the record budget
+        std::vector<binary::ValueRecord> shared_items(48, good);
+        for (std::uint32_t i = 0; i + 2 < shared_items.size(); ++i) {
+            shared_items[i].kind = static_cast<std::uint8_t>(yini::TokenKind::Array);
+            shared_items[i].payload = binary::pack(i + 1, 2);
+        }
+        craft({array_root}, shared_items);
+        assert(rejects(snapshot));
+
+        std::vector<binary::SectionRecord> siblings(40);
+        for (std::uint32_t i = 0; i < siblings.size(); ++i) {
+            siblings[i].first_child = i + 1;
+            siblings[i].child_count = std::min<std::uint32_t>(2, static_cast<std::uint32_t>(siblings.size()) - 1 - i);
+        }
+        craft(siblings, {});
+        assert(rejects(snapshot));
+
+        binary::ValueRecord bad_string{};
+        bad_string.kind = static_cast<std::uint8_t>(yini::TokenKind::String);
+        bad_string.payload = binary::pack(0, 16);
+        binary::SectionRecord two_values{};
+        two_values.value_count = 2;
+        craft({two_values}, {good, bad_string});
+        yini::Parser intact;
+        intact["keep"] = 1;
+        assert(rejects(intact));
+        assert(intact.root().value_count() == 1 && intact["keep"].as_int() == 1);
+
+        // Counts that overrun the payload cannot be cancelled out by a
+        // string_bytes that wraps the total back to the payload size
+        craft({binary::SectionRecord{}}, {}, [](binary::Header& header) {
+            header.section_count = 4;
+            header.string_bytes = std::uint64_t{0} - 3 * sizeof(binary::SectionRecord);
+        });
+        assert(rejects(intact));
+        craft({binary::SectionRecord{}}, {good}, [](binary::Header& header) {
+            header.value_count = 3;
+            header.string_bytes = std::uint64_t{0} - 2 * sizeof(binary::ValueRecord);
+        });
+        assert(rejects(intact));
+        assert(intact["keep"].as_int() == 1);
+        std::remove("test_output.yinib");
+        
+        // Test 9: Source order round-trip and skipping unchanged writes
+        std::cout << "Testing ordered round-trip..." << std::endl;
+        const std::string ordered_source =
+            "zeta = 1\n"
+            "alpha = 'two'\n"
+            "mid = [1, 2]\n"
+            "^ zulu\n"
+            "    b = true\n"
+            "    a = 2.5\n"
+            "\n"
+            "    ^^ inner\n"
+            "        y = 1\n"
+            "        x = 2\n"
+            "\n"
+            "^ alpha\n"
+            "    k = 'v'\n";
+        yini::Parser ordered;
+        ordered.parse_string(ordered_source);
+        assert(ordered.write_string() == ordered_source);
+        
+        yini::Parser reopened;
+        reopened.parse_string("b = 1\n^ s\nx = 1\n^ t\n^ s\ny = 2\nx = 3\n");
+        assert(reopened.write_string() == "b = 1\n^ s\n    x = 3\n    y = 2\n\n^ t\n");
+        
+        assert(ordered.root().erase_value("alpha"));
+        assert(!ordered.root().erase_value("alpha"));
+        assert(ordered.root().erase_section("zulu"));
+        assert(ordered.root().value_count() == 2 && ordered.root().section_count() == 1);
+        assert(ordered.write_string() == "zeta = 1\nmid = [1, 2]\n^ alpha\n    k = 'v'\n");
+        assert(ordered["mid"].array_ref().size() == 2);
+        ordered["alpha"] = 3;
+        assert(ordered.write_string() == "zeta = 1\nmid = [1, 2]\nalpha = 3\n^ alpha\n    k = 'v'\n");
+        
+        yini::Parser same;
+        same.parse_string(ordered.write_string());
+        assert(same.content_hash() == ordered.content_hash());
+        same["zeta"] = 2;
+        assert(same.content_hash() != ordered.content_hash());
+        
+        std::remove("test_output_ordered.yini");
+        assert(ordered.write_file_if_changed("test_output_ordered.yini"));
+        assert(!ordered.write_file_if_changed("test_output_ordered.yini"));
+        assert(same.write_file_if_changed("test_output_ordered.yini"));
+        {
+            std::ifstream in("test_output_ordered.yini");
+            std::string changed((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            assert(changed == same.write_string());
+        }
+        for (const auto& entry : std::filesystem::directory_iterator(".")) {
+            assert(entry.path().filename().string().rfind("test_output_ordered.yini.", 0) != 0);
+        }
+        std::remove("test_output_ordered.yini");
+        
         std::cout << "All tests passed" << std::endl;
         
     } catch (const std::exception& e) {